@@ -0,0 +1,123 @@
+/**
+ * @file   DelayArena.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the delay memory arena
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "DelayArena.h"
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__linux__)
+  #include <sys/mman.h>
+#endif
+
+// size of a transparent huge page on x86-64/aarch64 linux
+static const size_t hugePageSize = 2 * 1024 * 1024;
+
+/**
+ * @brief Allocates (and zeroes) arena memory
+ * 
+ * @param count        number of doubles needed
+ * @param useHugePages try to back memory with huge pages (linux only)
+ * 
+ * @return true if memory was allocated
+ */
+bool DelayArena::allocate(size_t count, bool useHugePages)
+{
+  release();
+
+  if (count == 0)
+    return true;
+
+  size_t bytes = padded(count) * sizeof(double);
+
+#if defined(__linux__)
+  if (useHugePages)
+  {
+    size_t mapBytes = (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+    void* p = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (p != MAP_FAILED)
+    {
+      // only a hint, kernel falls back to regular pages if it can't comply
+      madvise(p, mapBytes, MADV_HUGEPAGE);
+
+      memory = static_cast<double*>(p);
+      mappedBytes = mapBytes;
+      capacity = padded(count);
+
+      // anonymous mappings are already zeroed
+      return true;
+    }
+  }
+#else
+  (void)useHugePages;
+#endif
+
+  raw = std::malloc(bytes + alignment);
+  if (!raw)
+    return false;
+
+  uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  memory = reinterpret_cast<double*>(aligned);
+  capacity = padded(count);
+
+  reset();
+
+  return true;
+}
+
+/**
+ * @brief Frees arena memory, all carved regions become invalid
+ * 
+ */
+void DelayArena::release()
+{
+#if defined(__linux__)
+  if (mappedBytes)
+    munmap(memory, mappedBytes);
+#endif
+
+  std::free(raw);
+
+  memory = nullptr;
+  raw = nullptr;
+  capacity = 0;
+  offset = 0;
+  mappedBytes = 0;
+}
+
+/**
+ * @brief Carves the next region out of the arena
+ * 
+ * @param n number of doubles
+ * 
+ * @return double* aligned region, nullptr if arena doesn't have room
+ */
+double* DelayArena::carve(size_t n)
+{
+  size_t size = padded(n);
+
+  if (offset + size > capacity)
+    return nullptr;
+
+  double* region = memory + offset;
+  offset += size;
+
+  return region;
+}
+
+/**
+ * @brief Zeroes every delay line carved from the arena
+ * 
+ */
+void DelayArena::reset()
+{
+  if (memory)
+    std::memset(memory, 0, capacity * sizeof(double));
+}
@@ -0,0 +1,78 @@
+/**
+ * @file   DelayArena.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Single contiguous allocator for all delay memory of a reverb
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Arena that hands out 64-byte aligned, contiguous regions of doubles
+ *        for delay lines. All memory is allocated up front, so nothing is
+ *        allocated (or fragmented) while processing, and every delay line
+ *        can be cleared with a single memset.
+ *
+ *        On Linux the arena can optionally be backed by huge pages.
+ * 
+ */
+class DelayArena
+{
+public:
+
+  // alignment of every carved region (in bytes), one cache line
+  static const size_t alignment = 64;
+
+  DelayArena() : memory(nullptr), raw(nullptr), capacity(0), offset(0), mappedBytes(0) { }
+  ~DelayArena() { release(); }
+
+  DelayArena(const DelayArena&) = delete;
+  DelayArena& operator=(const DelayArena&) = delete;
+
+  // allocates room for count doubles (released memory is replaced)
+  bool allocate(size_t count, bool useHugePages = false);
+
+  // frees all arena memory
+  void release();
+
+  // hands out the next n doubles, nullptr if arena is full
+  double* carve(size_t n);
+
+  // start carving again from the beginning (memory is kept)
+  void rewind() { offset = 0; }
+
+  // zeroes all arena memory with one memset
+  void reset();
+
+  // size of n doubles once padded to the arena alignment
+  static size_t padded(size_t n)
+  {
+    const size_t perLine = alignment / sizeof(double);
+    return (n + perLine - 1) / perLine * perLine;
+  }
+
+  // start of arena memory (every carved region lives inside it)
+  double* data() const { return memory; }
+
+  size_t getCapacity() const { return capacity; }
+  size_t getUsed() const { return offset; }
+  bool usesHugePages() const { return mappedBytes != 0; }
+
+private:
+
+  // aligned memory handed out by carve
+  double* memory;
+
+  // pointer returned by the allocator (if not mapped)
+  void* raw;
+
+  // size and current carve position (in doubles)
+  size_t capacity, offset;
+
+  // size of mapping when backed by huge pages (0 otherwise)
+  size_t mappedBytes;
+};
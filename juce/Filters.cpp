@@ -4,10 +4,13 @@
  * @date   2022-03-17
  * @brief  Implementation of all filter class operators
  *
- * @note   Modified 2022-06-12
+ * @note   Modified 2026-10-19
  */
 
 #include "Filters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 /**
  * @brief Lowpass filter operator
@@ -30,7 +33,7 @@ float LowPass::operator()(float x)
   float y = (double)x + g * y1;
 
   // update past y variable
-  y1 = y;
+  y1 = flushDenormal(y);
 
   // return modified signal
   return y;
@@ -61,36 +64,85 @@ float LowPass::operator()(float x)
  * @return float 
  */
 float LowPassComb::operator()(float x)
+{
+  return (float)tick(x);
+}
+
+/**
+ * @brief Lowpass-comb operator without rounding the output to float
+ * 
+ * @param x input
+ * 
+ * @return double 
+ */
+double LowPassComb::tick(double x)
 {
   double y = 0;
 
-  if (!isDirty)
+  if (L > 0)
   {
-    if (!delayX1.empty() && !delayX2.empty() && !delayY2.empty())
-    {
-      // filter function 
-      y = delayX1.front() - (g * delayX2.front()) 
-                 + (g * y1) + (R * delayY2.front());
-  
-      // pop off front of queues
-      delayX1.pop();
-      delayX2.pop();
-      delayY2.pop();
+    // filter function 
+    y = delayX.read(L) - (g * delayX.read(L + 1)) 
+               + (g * y1) + (R * delayY.read(L));
 
-      // push new x/y into back of queues
-      delayX1.push((double)x);
-      delayX2.push((double)x);
-      delayY2.push(y);
+    // decaying tails never reach denormal range
+    y = flushDenormal(y);
 
-      // set single past y variable
-      y1 = y;
+    // push new x/y into delay lines (overwriting oldest values)
+    delayX.write(x);
+    delayY.write(y);
 
-    }
+    // set single past y variable
+    y1 = y;
   }
 
   return y;
 }
 
+/**
+ * @brief Gets coefficients, delay, past values and line positions
+ * 
+ * @return LowPassComb::State 
+ */
+LowPassComb::State LowPassComb::getState() const
+{
+  State s;
+
+  s.L = L;
+  s.posX = delayX.getPosition();
+  s.posY = delayY.getPosition();
+  s.pad = 0;
+  s.R = R;
+  s.g = g;
+  s.ratio = ratio;
+  s.lpG = lp.getCoefficient();
+  s.lpY1 = lp.getState();
+  s.y1 = y1;
+
+  return s;
+}
+
+/**
+ * @brief Restores a state from getState, R is copied rather than recomputed
+ *        so the restored filter is bit exact
+ * 
+ * @param s state to restore
+ */
+void LowPassComb::setState(const State& s)
+{
+  setDelay(s.L);
+
+  R = s.R;
+  g = s.g;
+  ratio = s.ratio;
+  lp.setCoefficient(s.lpG);
+  lp.setState(s.lpY1);
+  y1 = s.y1;
+
+  delayX.setPosition(s.posX);
+  delayY.setPosition(s.posY);
+}
+
 /**
  * @brief All pass filter with modifiable delay value (m)
  *
@@ -115,19 +167,483 @@ float AllPass::operator()(float x)
 {
   double y = 0;
   
-  if (!isDirty)
+  if (m > 0)
+  {
+    y = flushDenormal(a * ((double)x - delayY.read(m)) + delayX.read(m));
+
+    delayX.write((double)x);
+    delayY.write(y);
+  }
+
+  return y;
+}
+
+// delay ratios for each diffuser stage relative to m, roughly 1/sqrt(3)
+// apart so the stage delays don't share common multiples
+static const double stageRatios[AllPassDiffuser::maxStages] = 
+  { 1.0, 0.577, 0.333, 0.193, 0.771, 0.447, 0.257, 0.149 };
+
+// stage k's length for base delay m (every stage needs at least one sample)
+static int stageLength(int m, int k)
+{
+  int len = (int)std::round(m * stageRatios[k]);
+  return len < 1 ? 1 : len;
+}
+
+/**
+ * @brief Gets the arena memory a diffuser needs for its largest layout
+ * 
+ * @param maxM_ largest base delay (in samples)
+ * 
+ * @return size_t number of doubles
+ */
+size_t AllPassDiffuser::memoryNeeded(int maxM_)
+{
+  size_t total = 0;
+
+  for (int k = 0; k < maxStages; ++k)
+    total += stageLength(maxM_, k);
+
+  return DelayArena::padded(total);
+}
+
+/**
+ * @brief Moves stage memory into a region of the arena
+ * 
+ * @param arena arena to carve from
+ * @param maxM_ largest base delay (in samples)
+ */
+void AllPassDiffuser::attach(DelayArena& arena, int maxM_)
+{
+  size_t size = memoryNeeded(maxM_);
+
+  memory = arena.carve(size);
+  memorySize = memory ? size : 0;
+  maxM = memory ? maxM_ : 0;
+  owned = std::vector<double>();
+
+  layoutArena();
+}
+
+/**
+ * @brief Gives every stage (running or not) a region sized for the largest
+ *        base delay, in stage order, and clears them all
+ * 
+ */
+void AllPassDiffuser::layoutArena()
+{
+  // arena regions are fixed by what was carved, owned ones fit the largest
+  // delay set so far
+  regionM = maxM ? maxM : (m > regionM ? m : regionM);
+
+  int base = (maxM && m > maxM) ? maxM : m;
+  size_t total = 0;
+
+  for (int k = 0; k < maxStages; ++k)
+  {
+    lengths[k] = stageLength(base, k);
+    offsets[k] = (int)total;
+    positions[k] = 0;
+    total += stageLength(regionM, k);
+  }
+
+  if (!maxM && total > memorySize)
+  {
+    owned.assign(total, 0.0);
+    memory = owned.data();
+    memorySize = total;
+  }
+
+  for (size_t i = 0; i < total; ++i)
+    memory[i] = 0.0;
+}
+
+/**
+ * @brief Moves owned stage memory into larger regions, running stages keep
+ *        their contents and positions
+ * 
+ * @param newM base delay the regions have to fit
+ */
+void AllPassDiffuser::growRegions(int newM)
+{
+  int grownOffsets[maxStages];
+  size_t total = 0;
+
+  for (int k = 0; k < maxStages; ++k)
+  {
+    grownOffsets[k] = (int)total;
+    total += stageLength(newM, k);
+  }
+
+  std::vector<double> grown(total, 0.0);
+
+  for (int k = 0; k < numStages; ++k)
+    std::memcpy(grown.data() + grownOffsets[k], memory + offsets[k], lengths[k] * sizeof(double));
+
+  for (int k = 0; k < maxStages; ++k)
+    offsets[k] = grownOffsets[k];
+
+  owned.swap(grown);
+  memory = owned.data();
+  memorySize = total;
+  regionM = newM;
+}
+
+/**
+ * @brief Changes one stage's length without leaving its region. The line is
+ *        unrolled oldest first, then the newest len samples are kept (a
+ *        longer line gets silence before them).
+ * 
+ * @param k   stage
+ * @param len new length (fits the stage's region)
+ */
+void AllPassDiffuser::resizeStage(int k, int len)
+{
+  double* buf = memory + offsets[k];
+  int old = lengths[k];
+
+  // the next sample read is the oldest
+  std::rotate(buf, buf + positions[k], buf + old);
+
+  if (len < old)
+    std::memmove(buf, buf + old - len, len * sizeof(double));
+  else
+  {
+    std::memmove(buf + len - old, buf, old * sizeof(double));
+    std::fill(buf, buf + len - old, 0.0);
+  }
+
+  lengths[k] = len;
+  positions[k] = 0;
+}
+
+/**
+ * @brief Sets the base delay, only stages whose length changes are touched
+ *        and they keep their tails (stages not running just take the new
+ *        length, they're cleared when they come back)
+ * 
+ * @param m_ base delay (in samples)
+ */
+void AllPassDiffuser::setDelay(int m_)
+{
+  if (m_ == m)
+    return;
+
+  m = m_;
+
+  // arena backed diffusers can't grow past what was carved for them
+  int base = (maxM && m > maxM) ? maxM : m;
+
+  if (!maxM && base > regionM)
+    growRegions(base);
+
+  for (int k = 0; k < maxStages; ++k)
   {
-    if (!delayX.empty() && !delayY.empty())
+    int len = stageLength(base, k);
+
+    if (len == lengths[k])
+      continue;
+
+    if (k < numStages)
+      resizeStage(k, len);
+    else
     {
-      y = a * ((double)x - delayY.front()) + delayX.front();
+      lengths[k] = len;
+      positions[k] = 0;
+    }
+  }
+}
+
+/**
+ * @brief Sets the stage count and topology. Stages that weren't running are
+ *        cleared before they join, the rest keep going. Setting what's
+ *        already there does nothing, so a quality level (or its fade)
+ *        survives parameter sets that don't touch the diffuser.
+ * 
+ * @param K       number of stages
+ * @param nested_ nested rather than cascaded
+ */
+void AllPassDiffuser::setStages(int K, bool nested_)
+{
+  K = K < 1 ? 1 : (K > maxStages ? maxStages : K);
+
+  if (K == numStages && nested_ == nested)
+    return;
 
-      delayX.pop();
-      delayY.pop();
+  int running = nested ? numStages : (activeStages > prevStages ? activeStages : prevStages);
 
-      delayX.push((double)x);
-      delayY.push(y);
+  for (int k = running; k < K; ++k)
+  {
+    std::fill(memory + offsets[k], memory + offsets[k] + lengths[k], 0.0);
+    positions[k] = 0;
+  }
+
+  numStages = K;
+  nested = nested_;
+  activeStages = prevStages = numStages;
+  fadeLength = 0;
+}
+
+/**
+ * @brief Gets coefficient, delay, stage layout and stage positions
+ * 
+ * @return AllPassDiffuser::State 
+ */
+AllPassDiffuser::State AllPassDiffuser::getState() const
+{
+  State s;
+
+  s.a = a;
+  s.m = m;
+  s.numStages = numStages;
+  s.nested = nested ? 1 : 0;
+  s.activeStages = activeStages;
+
+  for (int k = 0; k < maxStages; ++k)
+    s.positions[k] = k < numStages ? positions[k] : 0;
+
+  return s;
+}
+
+/**
+ * @brief Restores a state from getState (stage memory is left as is, the
+ *        owner copies it in afterwards)
+ * 
+ * @param s state to restore
+ */
+void AllPassDiffuser::setState(const State& s)
+{
+  a = s.a;
+  setStages(s.numStages, s.nested != 0);
+  setDelay(s.m);
+
+  // the saved stage count applies at once, whatever fade was running here
+  activeStages = prevStages = numStages;
+  fadeLength = 0;
+  setActiveStages(s.activeStages, 0);
+
+  for (int k = 0; k < numStages; ++k)
+    positions[k] = (s.positions[k] >= 0 && s.positions[k] < lengths[k]) ? s.positions[k] : 0;
+}
+
+/**
+ * @brief Changes how many cascaded stages are run. Stages switched back on
+ *        are cleared first, since their memory went stale while idle.
+ * 
+ * @param k           stages to run (clamped to 1 - numStages)
+ * @param fadeSamples crossfade length (0 switches immediately)
+ */
+void AllPassDiffuser::setActiveStages(int k, int fadeSamples)
+{
+  k = k < 1 ? 1 : (k > numStages ? numStages : k);
+
+  if (k == activeStages)
+    return;
+
+  for (int j = activeStages; j < k; ++j)
+  {
+    for (int i = 0; i < lengths[j]; ++i)
+      memory[offsets[j] + i] = 0.0;
+
+    positions[j] = 0;
+  }
+
+  prevStages = activeStages;
+  activeStages = k;
+  fadePos = 0;
+  fadeLength = fadeSamples > 0 ? fadeSamples : 0;
+}
+
+/**
+ * @brief Cascaded block while the stage count is changing. Runs the larger
+ *        of both stage counts, taps the output after the smaller one and
+ *        linearly fades from the old count's output to the new one's.
+ * 
+ * @param samples    samples to process (in place)
+ * @param numSamples number of samples
+ */
+template <class Sample>
+void AllPassDiffuser::processFade(Sample* samples, int numSamples)
+{
+  const int K = activeStages > prevStages ? activeStages : prevStages;
+  const int tap = activeStages < prevStages ? activeStages : prevStages;
+  const bool growing = activeStages > prevStages;
+  double* base = memory;
+
+  for (int i = 0; i < numSamples; ++i)
+  {
+    double s = samples[i];
+    double tapped = 0.0;
+
+    for (int k = 0; k < K; ++k)
+    {
+      if (k == tap)
+        tapped = s;
+
+      double* buf = base + offsets[k];
+      double w = buf[positions[k]];
+      double v = s - a * w;
+
+      buf[positions[k]] = v;
+      s = a * v + w;
+
+      if (++positions[k] == lengths[k])
+        positions[k] = 0;
     }
+
+    double t = fadePos < fadeLength ? (double)fadePos / fadeLength : 1.0;
+    double from = growing ? tapped : s;
+    double to = growing ? s : tapped;
+
+    samples[i] = (Sample)(from + t * (to - from));
+
+    if (fadePos < fadeLength)
+      ++fadePos;
   }
 
-  return y;
+  // fade finished, idle stages stop running
+  if (fadePos >= fadeLength)
+  {
+    prevStages = activeStages;
+    fadeLength = 0;
+  }
+}
+
+/**
+ * @brief Allpass diffuser operator, each stage computed in canonical form
+ *        (single delay line per stage)
+ *
+ *   cascaded:
+ *
+ *   X                                        Y
+ *  ---> | AP(m0) | ---> | AP(m1) | ... ---> 
+ *
+ *   nested:
+ *
+ *   X                                                  Y
+ *  ---> [SUM] ---> | z^-m0 -> AP(m1) ... | ---> [SUM] --->
+ *         |   <-------- *-a --------------|       |
+ *         |----------------- *a ----------------->|
+ *
+ *
+ *    vt = x - a*w
+ *    yt = a*vt + w
+ *
+ *    w = v_(t-m)            <-- cascaded (or innermost nested stage)
+ *    w = AP_next(v_(t-m))   <-- nested
+ *    
+ * @param x input
+ * 
+ * @return float 
+ */
+float AllPassDiffuser::operator()(float x)
+{
+  process(&x, 1);
+
+  return x;
+}
+
+/**
+ * @brief Block allpass diffuser, all stages are run per sample so no stage
+ *        writes an intermediate block back to memory
+ * 
+ * @param samples    samples to process (in place)
+ * @param numSamples number of samples
+ */
+void AllPassDiffuser::process(float* samples, int numSamples)
+{
+  processSamples(samples, numSamples);
+}
+
+/**
+ * @brief Double block allpass diffuser
+ * 
+ * @param samples    samples to process (in place)
+ * @param numSamples number of samples
+ */
+void AllPassDiffuser::process(double* samples, int numSamples)
+{
+  processSamples(samples, numSamples);
+}
+
+/**
+ * @brief Diffuser kernel, every stage runs in double whatever the sample type
+ * 
+ * @param samples    samples to process (in place)
+ * @param numSamples number of samples
+ */
+template <class Sample>
+void AllPassDiffuser::processSamples(Sample* samples, int numSamples)
+{
+  ScopedFlushToZero ftz;
+
+  const int K = nested ? numStages : activeStages;
+  double* base = memory;
+
+  // cascaded diffuser changing stage count, blend the outputs of both
+  if (!nested && fadeLength)
+  {
+    processFade(samples, numSamples);
+    return;
+  }
+
+  // keep indices local for the duration of the block
+  int pos[maxStages];
+  for (int k = 0; k < K; ++k)
+    pos[k] = positions[k];
+
+  if (!nested)
+  {
+    for (int i = 0; i < numSamples; ++i)
+    {
+      double s = samples[i];
+
+      for (int k = 0; k < K; ++k)
+      {
+        double* buf = base + offsets[k];
+        double w = buf[pos[k]];
+        double v = s - a * w;
+
+        buf[pos[k]] = v;
+        s = a * v + w;
+
+        if (++pos[k] == lengths[k])
+          pos[k] = 0;
+      }
+
+      samples[i] = (Sample)s;
+    }
+  }
+  else
+  {
+    // u[k] is the input of stage k (u[K] is the innermost delay output)
+    double u[maxStages + 1];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+      u[0] = samples[i];
+
+      // every inner input is a past value, so read them all first
+      for (int k = 0; k < K; ++k)
+        u[k + 1] = base[offsets[k] + pos[k]];
+
+      // work outwards from the innermost stage
+      double w = u[K];
+      for (int k = K - 1; k >= 0; --k)
+      {
+        double v = u[k] - a * w;
+
+        base[offsets[k] + pos[k]] = v;
+        w = a * v + w;
+
+        if (++pos[k] == lengths[k])
+          pos[k] = 0;
+      }
+
+      samples[i] = (Sample)w;
+    }
+  }
+
+  for (int k = 0; k < K; ++k)
+    positions[k] = pos[k];
 }
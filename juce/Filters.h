@@ -4,12 +4,14 @@
  * @date   2022-03-17
  * @brief  Collection of filter classes, ranging from 
  *
- * @note   Modified 2022-06-12
+ * @note   Modified 2026-10-19
  */
 
 #pragma once
 
-#include <queue>
+#include "DelayArena.h"
+#include "Denormals.h"
+#include <vector>
 
 /**
  * @brief Parent class to all filter classes
@@ -19,8 +21,20 @@ class Filter
 {
 public:
 
+  virtual ~Filter() = default;
+
   // virtual filter operator
   virtual float operator()(float input) = 0;
+
+  // block operator, processes samples in place
+  // (defaults to running the per sample operator over the block)
+  virtual void process(float* samples, int numSamples)
+  {
+    ScopedFlushToZero ftz;
+
+    for (int i = 0; i < numSamples; ++i)
+      samples[i] = (*this)(samples[i]);
+  }
   
 private:
 };
@@ -39,7 +53,11 @@ public:
   // set coefficient
   void setCoefficient(double g_) { g = g_; }
 
-  double getCoefficient() { return g; }
+  double getCoefficient() const { return g; }
+
+  // past output, for checkpointing
+  double getState() const { return y1; }
+  void setState(double y1_) { y1 = y1_; }
 
   // all dsp work done here
   float operator()(float x) override;
@@ -50,6 +68,102 @@ private:
   double y1, g;
 };
 
+/**
+ * @brief Ring buffer delay line. Memory is either attached from outside
+ *        (a DelayArena region) or owned by the line itself, so filters can
+ *        be used standalone or as part of a reverb's arena.
+ * 
+ */
+class DelayLine
+{
+public:
+
+  // ctor
+  DelayLine() : buffer(nullptr), capacity(0), pos(0), external(false) { }
+
+  DelayLine(const DelayLine&) = delete;
+  DelayLine& operator=(const DelayLine&) = delete;
+
+  // uses external memory (size samples) for this line and clears it
+  void attach(double* memory, int size)
+  {
+    owned = std::vector<double>();
+    buffer = memory;
+    capacity = memory ? size : 0;
+    external = memory != nullptr;
+    clear();
+  }
+
+  // makes sure an unattached line can hold size samples, history is kept
+  // (oldest first, the samples before it read back as silence)
+  void reserve(int size)
+  {
+    if (external || size <= capacity)
+      return;
+
+    std::vector<double> grown(size, 0.0);
+    for (int d = capacity; d >= 1; --d)
+      grown[capacity - d] = read(d);
+
+    owned.swap(grown);
+    buffer = owned.data();
+    pos = capacity;
+    capacity = size;
+  }
+
+  // value written d samples ago (1 <= d <= capacity)
+  double read(int d) const
+  {
+    int i = pos - d;
+    return buffer[i < 0 ? i + capacity : i];
+  }
+
+  // value written d samples ago, linearly interpolated (1 <= d < capacity)
+  double readLinear(double d) const
+  {
+    int whole = (int)d;
+    double a = read(whole);
+    return a + (d - whole) * (read(whole + 1) - a);
+  }
+
+  // pushes newest value into the line
+  void write(double v)
+  {
+    buffer[pos] = v;
+    if (++pos == capacity)
+      pos = 0;
+  }
+
+  // zeroes all history
+  void clear()
+  {
+    for (int i = 0; i < capacity; ++i)
+      buffer[i] = 0.0;
+    pos = 0;
+  }
+
+  int getCapacity() const { return capacity; }
+  bool isExternal() const { return external; }
+
+  // index of next write, for checkpointing (contents are restored by whoever
+  // owns the memory)
+  int getPosition() const { return pos; }
+  void setPosition(int p) { pos = (p >= 0 && p < capacity) ? p : 0; }
+
+private:
+
+  // memory being used (external or owned.data())
+  double* buffer;
+
+  // size of buffer, and index of next write
+  int capacity, pos;
+
+  bool external;
+
+  // memory used when no arena has been attached
+  std::vector<double> owned;
+};
+
 /**
  * @brief Lowpass-comb filter w/ added ratio functionality, mainly used
  *        for Moorer reverb algorithm
@@ -60,7 +174,20 @@ class LowPassComb : public Filter
 public:
 
   // ctor
-  LowPassComb() :g(0.0), R(0.0), L(0), y1(0.0) { }
+  LowPassComb() : L(0), R(0.0), g(0.0), ratio(0.0), y1(0.0) { }
+
+  // doubles of arena memory needed for delays up to maxL
+  static size_t memoryNeeded(int maxL)
+  {
+    return DelayArena::padded(maxL + 1) + DelayArena::padded(maxL);
+  }
+
+  // carves delay memory for delays up to maxL out of arena
+  void attach(DelayArena& arena, int maxL)
+  {
+    delayX.attach(arena.carve(maxL + 1), maxL + 1);
+    delayY.attach(arena.carve(maxL), maxL);
+  }
 
   void setCoefficients(double R_, double g_) 
   { 
@@ -69,35 +196,47 @@ public:
     R = ratio - (ratio * g);
   }
 
+  // lines always hold their full capacity of history, so a new delay just
+  // reads from another point in it (the tail carries on, nothing is cleared)
   void setDelay(int L_)
   { 
-    isDirty = true;
-    // if real time, do we need this to reinitialize the queues???
-    L = L_; 
-    
-    std::queue<double> e1, e2, e3;
-    std::swap(delayX1, e1);
-    std::swap(delayX2, e2);
-    std::swap(delayY2, e3);
-
-    // delayX1 = new std::queue<double>()
-  
-    for (int i = 0; i < L; ++i)
-    {
-      delayX1.push(0.0f);
-      delayX2.push(0.0f);
-      delayY2.push(0.0f);
-    }
-
     // one extra delay for (x_(t-L-1)
-    delayX2.push(0.0f);
+    delayX.reserve(L_ + 1);
+    delayY.reserve(L_);
 
-    if (isDirty)
-      isDirty = false;
+    // arena backed lines can't grow past what was carved for them
+    L = L_ < delayY.getCapacity() ? L_ : delayY.getCapacity();
   }
 
+  // zeroes the single past y value (delay lines are cleared by their owner)
+  void clearFeedback() { y1 = 0.0; }
+
+  // zeroes delay lines and past values, coefficients/delay are kept
+  void clear()
+  {
+    delayX.clear();
+    delayY.clear();
+    y1 = 0.0;
+  }
+
+  // everything but delay contents (plain data, written out as is)
+  struct State
+  {
+    int L, posX, posY, pad;
+    double R, g, ratio, lpG, lpY1, y1;
+  };
+
+  State getState() const;
+
+  // restores coefficients/delay, then past values and line positions
+  // (delay contents have to be copied in afterwards)
+  void setState(const State& s);
+
   float operator()(float x) override;
 
+  // per sample operator at full precision (what operator() rounds to float)
+  double tick(double x);
+
   // low pass object (public to allow access to setters)
   LowPass lp;
 
@@ -109,11 +248,9 @@ public:
 
 private:
 
-  bool isDirty;
-  
-  // x/y delay queues
-  std::queue<double> delayX1, delayX2;
-  std::queue<double> delayY2;
+  // x/y delay lines (x holds L + 1 samples for x_(t-L-1))
+  DelayLine delayX;
+  DelayLine delayY;
 
   double y1;
 };
@@ -129,31 +266,48 @@ public:
   // ctor
   AllPass() : m(0), a(0.0) { }
 
+  // doubles of arena memory needed for delays up to maxM
+  static size_t memoryNeeded(int maxM) { return 2 * DelayArena::padded(maxM); }
+
+  // carves delay memory for delays up to maxM out of arena
+  void attach(DelayArena& arena, int maxM)
+  {
+    delayX.attach(arena.carve(maxM), maxM);
+    delayY.attach(arena.carve(maxM), maxM);
+  }
+
   void setCoefficient(double a_) { a = a_; }
 
+  // everything but delay contents (plain data, written out as is)
+  struct State
+  {
+    int m, posX, posY, pad;
+    double a;
+  };
+
+  State getState() const { return { m, delayX.getPosition(), delayY.getPosition(), 0, a }; }
+
+  // restores coefficient/delay, then line positions (delay contents have to
+  // be copied in afterwards)
+  void setState(const State& s)
+  {
+    a = s.a;
+    setDelay(s.m);
+    delayX.setPosition(s.posX);
+    delayY.setPosition(s.posY);
+  }
+
+  // keeps history, same as LowPassComb::setDelay
   void setDelay(int m_) 
   { 
-    isDirty = true;
-    m = m_; 
-    
-    std::queue<double> e1, e2;
-    std::swap(delayX, e1);
-    std::swap(delayY, e2);
-
-    for (int i = 0; i < m; ++i)
-    {
-      delayX.push(0.0f);
-      delayY.push(0.0f);
-    }
+    delayX.reserve(m_);
+    delayY.reserve(m_);
 
-    if (isDirty)
-      isDirty = false;
+    m = m_ < delayY.getCapacity() ? m_ : delayY.getCapacity();
   }
 
   float operator()(float x) override;
 
-  bool isDirty;
-
 private:
 
   // delay value (in samples)
@@ -162,7 +316,137 @@ private:
   // coeff
   double a;
 
-  // x/y delay queues
-  std::queue<double> delayX;
-  std::queue<double> delayY;
+  // x/y delay lines
+  DelayLine delayX;
+  DelayLine delayY;
+};
+
+/**
+ * @brief Diffuser made of K allpass stages, either cascaded (in series) or
+ *        nested (each stage's delay contains the next stage). All stages
+ *        share one contiguous delay arena, and the block operator runs every
+ *        stage per sample so the intermediate signal never leaves registers.
+ *
+ *        Stage k uses delay m * stageRatios[k] and the shared coefficient a,
+ *        so a single stage behaves exactly like AllPass. Every stage owns a
+ *        fixed region sized for the largest delay, so delay and stage count
+ *        changes only touch the stages involved and keep their history.
+ * 
+ */
+class AllPassDiffuser : public Filter
+{
+public:
+
+  // most stages a diffuser can hold
+  static const int maxStages = 8;
+
+  // ctor
+  AllPassDiffuser() : a(0.0), m(0), numStages(1), nested(false), activeStages(1), prevStages(1),
+                      fadePos(0), fadeLength(0), memory(nullptr), memorySize(0), maxM(0), regionM(0)
+  { 
+    layoutArena(); 
+  }
+
+  AllPassDiffuser(const AllPassDiffuser&) = delete;
+  AllPassDiffuser& operator=(const AllPassDiffuser&) = delete;
+
+  // doubles of arena memory needed for base delays up to maxM_ (any stage count)
+  static size_t memoryNeeded(int maxM_);
+
+  // carves stage memory for base delays up to maxM_ out of arena
+  void attach(DelayArena& arena, int maxM_);
+
+  void setCoefficient(double a_) { a = a_; }
+  double getCoefficient() { return a; }
+
+  // sets base delay (in samples), stage delays are derived from it and
+  // resized in place (each keeps its newest samples)
+  void setDelay(int m_);
+
+  int getDelay() { return m; }
+
+  // sets number of stages (clamped to 1 - maxStages) and topology, stages
+  // added start from silence, the others keep their history
+  void setStages(int K, bool nested_);
+
+  int getNumStages() { return numStages; }
+  bool isNested() { return nested; }
+
+  // runs only the first k stages (cascaded only, nested diffusers always run
+  // every stage), crossfading between the two outputs over fadeSamples.
+  // Stages coming back in start from silence, no memory is relaid out.
+  void setActiveStages(int k, int fadeSamples);
+
+  int getActiveStages() { return activeStages; }
+
+  // everything but stage memory (plain data, written out as is)
+  struct State
+  {
+    double a;
+    int m, numStages, nested, activeStages;
+    int positions[maxStages];
+  };
+
+  State getState() const;
+
+  // restores coefficient/delay/stages, then stage positions (stage memory
+  // has to be copied in afterwards)
+  void setState(const State& s);
+
+  float operator()(float x) override;
+  void process(float* samples, int numSamples) override;
+
+  // double block operator (same kernel, samples never pass through float)
+  void process(double* samples, int numSamples);
+
+private:
+
+  // block kernel shared by the float and double operators
+  template <class Sample>
+  void processSamples(Sample* samples, int numSamples);
+
+  // cascaded block used while the active stage count is crossfading
+  template <class Sample>
+  void processFade(Sample* samples, int numSamples);
+
+  // lays out every stage's region for regionM and clears stage memory
+  void layoutArena();
+
+  // moves owned stage memory to regions sized for base delay newM (history
+  // is copied over)
+  void growRegions(int newM);
+
+  // changes stage k's length in place, keeping its newest samples
+  void resizeStage(int k, int len);
+
+  // coeff
+  double a;
+
+  // base delay value (in samples)
+  int m;
+
+  int numStages;
+  bool nested;
+
+  // stages being run (<= numStages), stages run before the last change, and
+  // crossfade progress between the two (samples)
+  int activeStages, prevStages;
+  int fadePos, fadeLength;
+
+  // per stage delay length, offset of its region and current read/write
+  // index (every stage has a length, even ones not running)
+  int lengths[maxStages];
+  int offsets[maxStages];
+  int positions[maxStages];
+
+  // one contiguous block holding every stage's delay line
+  double* memory;
+  size_t memorySize;
+
+  // largest base delay attached memory was sized for (0 if memory is owned),
+  // and the base delay stage regions are laid out for
+  int maxM, regionM;
+
+  // memory used when no arena has been attached
+  std::vector<double> owned;
 };
\ No newline at end of file
@@ -0,0 +1,513 @@
+/**
+ * @file   FixedFilters.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Integer (fixed point) versions of the lowpass, lowpass-comb and
+ *         allpass filters for targets without a fast fpu. Same Filter/block
+ *         API as the floating point filters, so either can be dropped in.
+ *
+ *         16 bit filters keep samples as Q3.12 and coefficients as Q1.14,
+ *         32 bit filters keep samples as Q3.28 and coefficients as Q2.29
+ *         (3 bits of headroom for comb peaks, coefficients sized so every
+ *         sum of products fits its accumulator). Delay lines hold the sample
+ *         type, a quarter (16 bit) or half (32 bit) of the double lines.
+ *         MoorerReverb can run its combs as either (setCombFormat).
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include "Filters.h"
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define FIXED_FILTERS_USE_SSE2 1
+#endif
+
+/**
+ * @brief Sample/coefficient format for each storage type, Acc is wide enough
+ *        for a sum of three sample * coefficient products
+ *
+ */
+template <class T> struct FixedFormat;
+
+template <> struct FixedFormat<int16_t>
+{
+  static const int fracBits = 12;
+  static const int coeffBits = 14;
+  typedef int32_t Acc;
+};
+
+template <> struct FixedFormat<int32_t>
+{
+  static const int fracBits = 28;
+  static const int coeffBits = 29;
+  typedef int64_t Acc;
+};
+
+/**
+ * @brief Conversion, saturation and requantization helpers for one format
+ *
+ */
+template <class T>
+struct Fixed
+{
+  static const int fracBits = FixedFormat<T>::fracBits;
+  static const int coeffBits = FixedFormat<T>::coeffBits;
+
+  // clamps to the sample range instead of wrapping
+  static T saturate(int64_t v)
+  {
+    const int64_t hi = std::numeric_limits<T>::max();
+    const int64_t lo = std::numeric_limits<T>::min();
+    return (T)(v > hi ? hi : (v < lo ? lo : v));
+  }
+
+  static T fromFloat(float x)
+  {
+    return saturate((int64_t)std::floor((double)x * (double)(1LL << fracBits) + 0.5));
+  }
+
+  static float toFloat(T v) { return (float)((double)v * (1.0 / (double)(1LL << fracBits))); }
+
+  // coefficients are limited to +-1 so three products always fit in Acc
+  static int64_t coefficient(double c)
+  {
+    c = c > 1.0 ? 1.0 : (c < -1.0 ? -1.0 : c);
+    return (int64_t)std::floor(c * (double)(1LL << coeffBits) + 0.5);
+  }
+
+  // drops the coefficient fraction bits of acc with first order error
+  // feedback, the last rounding error is added back before rounding so the
+  // error is shaped by (1 - z^-1) away from dc and decaying tails don't
+  // get stuck in limit cycles
+  static T requantize(int64_t acc, int64_t& error)
+  {
+    acc += error;
+
+    int64_t q = (acc + (1LL << (coeffBits - 1))) >> coeffBits;
+    error = acc - q * (1LL << coeffBits);
+
+    return saturate(q);
+  }
+};
+
+/**
+ * @brief out = ca*a + cb*b + cc*c for n samples (the feed forward part of
+ *        every fixed filter, the recursive part runs afterwards)
+ *
+ */
+template <class T>
+inline void fixedMultiplyAdd(const T* a, const T* b, const T* c, int64_t ca, int64_t cb, int64_t cc,
+                             typename FixedFormat<T>::Acc* out, int n)
+{
+  for (int i = 0; i < n; ++i)
+    out[i] = (typename FixedFormat<T>::Acc)(ca * a[i] + cb * b[i] + cc * c[i]);
+}
+
+#if defined(FIXED_FILTERS_USE_SSE2)
+
+/**
+ * @brief 16 bit multiply-add, 8 samples at a time with pmaddwd (a/b are
+ *        interleaved so one instruction does both products and their sum)
+ *
+ */
+inline void fixedMultiplyAdd(const int16_t* a, const int16_t* b, const int16_t* c, int64_t ca, int64_t cb, int64_t cc,
+                             int32_t* out, int n)
+{
+  const __m128i cab = _mm_set1_epi32((int32_t)((uint16_t)ca | ((uint32_t)(uint16_t)cb << 16)));
+  const __m128i cc0 = _mm_set1_epi32((int32_t)(uint16_t)cc);
+  const __m128i zero = _mm_setzero_si128();
+
+  int i = 0;
+
+  for (; i + 8 <= n; i += 8)
+  {
+    __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+    __m128i vc = _mm_loadu_si128((const __m128i*)(c + i));
+
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(va, vb), cab),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(vc, zero), cc0));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(va, vb), cab),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(vc, zero), cc0));
+
+    _mm_storeu_si128((__m128i*)(out + i), lo);
+    _mm_storeu_si128((__m128i*)(out + i + 4), hi);
+  }
+
+  for (; i < n; ++i)
+    out[i] = (int32_t)(ca * a[i] + cb * b[i] + cc * c[i]);
+}
+
+#endif
+
+/**
+ * @brief Ring buffer delay line of fixed point samples, with block reads and
+ *        writes so the feed forward math can run over contiguous memory
+ *
+ */
+template <class T>
+class FixedDelayLine
+{
+public:
+
+  FixedDelayLine() : pos(0) { }
+
+  // makes room for size samples, history is kept unless the line has to
+  // grow (reads of any delay up to the capacity stay valid)
+  void reserve(int size)
+  {
+    if (size <= (int)buffer.size())
+      return;
+
+    buffer.assign(size, 0);
+    pos = 0;
+  }
+
+  void clear()
+  {
+    std::fill(buffer.begin(), buffer.end(), (T)0);
+    pos = 0;
+  }
+
+  // value written d samples ago (1 <= d <= capacity)
+  T read(int d) const
+  {
+    int i = pos - d;
+    return buffer[i < 0 ? i + (int)buffer.size() : i];
+  }
+
+  void write(T v)
+  {
+    buffer[pos] = v;
+    if (++pos == (int)buffer.size())
+      pos = 0;
+  }
+
+  // copies the n values the next n reads of read(d) would return (n <= d)
+  void readBlock(int d, T* dst, int n) const
+  {
+    const int size = (int)buffer.size();
+    int i = pos - d;
+    if (i < 0)
+      i += size;
+
+    int first = n < size - i ? n : size - i;
+    std::memcpy(dst, &buffer[i], first * sizeof(T));
+    std::memcpy(dst + first, &buffer[0], (n - first) * sizeof(T));
+  }
+
+  void writeBlock(const T* src, int n)
+  {
+    const int size = (int)buffer.size();
+    int first = n < size - pos ? n : size - pos;
+
+    std::memcpy(&buffer[pos], src, first * sizeof(T));
+    std::memcpy(&buffer[0], src + first, (n - first) * sizeof(T));
+
+    pos += n;
+    if (pos >= size)
+      pos -= size;
+  }
+
+  int getCapacity() const { return (int)buffer.size(); }
+
+private:
+
+  std::vector<T> buffer;
+  int pos;
+};
+
+/**
+ * @brief Fixed point lowpass, yt = x + gy_(t-1)
+ *
+ */
+template <class T>
+class FixedLowPass : public Filter
+{
+public:
+
+  // ctor
+  FixedLowPass() : g(0), y1(0), error(0) { }
+
+  void setCoefficient(double g_) { g = Fixed<T>::coefficient(g_); }
+
+  float operator()(float x) override
+  {
+    int64_t acc = (int64_t)Fixed<T>::fromFloat(x) * (1LL << Fixed<T>::coeffBits) + g * y1;
+
+    y1 = Fixed<T>::requantize(acc, error);
+
+    return Fixed<T>::toFloat(y1);
+  }
+
+private:
+
+  int64_t g;
+  T y1;
+
+  // rounding error carried to the next sample
+  int64_t error;
+};
+
+/**
+ * @brief Fixed point lowpass-comb, same filter (and R/g/ratio handling) as
+ *        LowPassComb
+ *
+ *    yt = x_(t-L) - gx_(t-L-1) + gy_(t-1) + Ry_(t-L)
+ *
+ *        The block operator computes the feed forward terms for up to L
+ *        samples at once (everything they read is at least L samples old),
+ *        leaving only the gy_(t-1) recursion per sample.
+ *
+ */
+template <class T>
+class FixedLowPassComb : public Filter
+{
+public:
+
+  // ctor
+  FixedLowPassComb() : L(0), R(0.0), g(0.0), ratio(0.0), gQ(0), RQ(0), y1(0), error(0) { }
+
+  void setCoefficients(double R_, double g_)
+  {
+    ratio = R_;
+    g = g_;
+    R = ratio - (ratio * g);
+
+    gQ = Fixed<T>::coefficient(g);
+    RQ = Fixed<T>::coefficient(R);
+  }
+
+  // keeps history like LowPassComb::setDelay (lines only grow, which
+  // clears them, so size them up front with setMaxDelay)
+  void setDelay(int L_)
+  {
+    L = L_ > 0 ? L_ : 0;
+
+    // one extra delay for (x_(t-L-1)
+    delayX.reserve(L + 1);
+    delayY.reserve(L);
+  }
+
+  // sizes the lines for delays up to maxL (allocates, not from the audio thread)
+  void setMaxDelay(int maxL)
+  {
+    delayX.reserve(maxL + 1);
+    delayY.reserve(maxL);
+  }
+
+  // zeroes delay lines and past values, coefficients/delay are kept
+  void clear()
+  {
+    delayX.clear();
+    delayY.clear();
+    y1 = 0;
+    error = 0;
+  }
+
+  float operator()(float x) override
+  {
+    if (L <= 0)
+      return 0.0f;
+
+    int64_t acc = (int64_t)delayX.read(L) * (1LL << Fixed<T>::coeffBits) - gQ * delayX.read(L + 1)
+                + gQ * y1 + RQ * delayY.read(L);
+
+    T y = Fixed<T>::requantize(acc, error);
+
+    delayX.write(Fixed<T>::fromFloat(x));
+    delayY.write(y);
+    y1 = y;
+
+    return Fixed<T>::toFloat(y);
+  }
+
+  void process(float* samples, int numSamples) override
+  {
+    if (L <= 0)
+    {
+      for (int i = 0; i < numSamples; ++i)
+        samples[i] = 0.0f;
+      return;
+    }
+
+    T x[blockSize], xL[blockSize], xL1[blockSize], yL[blockSize], y[blockSize];
+    typename FixedFormat<T>::Acc u[blockSize];
+
+    const int chunk = L < blockSize ? L : blockSize;
+    const int64_t one = 1LL << Fixed<T>::coeffBits;
+
+    for (int start = 0; start < numSamples; start += chunk)
+    {
+      int n = numSamples - start < chunk ? numSamples - start : chunk;
+      float* s = samples + start;
+
+      for (int i = 0; i < n; ++i)
+        x[i] = Fixed<T>::fromFloat(s[i]);
+
+      delayX.readBlock(L, xL, n);
+      delayX.readBlock(L + 1, xL1, n);
+      delayY.readBlock(L, yL, n);
+
+      fixedMultiplyAdd(xL, xL1, yL, one, -gQ, RQ, u, n);
+
+      T last = y1;
+      for (int i = 0; i < n; ++i)
+      {
+        last = Fixed<T>::requantize((int64_t)u[i] + gQ * last, error);
+        y[i] = last;
+        s[i] = Fixed<T>::toFloat(last);
+      }
+      y1 = last;
+
+      delayX.writeBlock(x, n);
+      delayY.writeBlock(y, n);
+    }
+  }
+
+  // delay value (in samples)
+  int L;
+
+  // dampening value + coefficient
+  double R, g, ratio;
+
+private:
+
+  // samples converted per pass of the block operator
+  static const int blockSize = 256;
+
+  // fixed point g/R
+  int64_t gQ, RQ;
+
+  // x/y delay lines (x holds L + 1 samples for x_(t-L-1))
+  FixedDelayLine<T> delayX;
+  FixedDelayLine<T> delayY;
+
+  T y1;
+
+  // rounding error carried to the next sample
+  int64_t error;
+};
+
+/**
+ * @brief Fixed point allpass, same filter as AllPass
+ *
+ *    yt = a*(x - y_(t-m)) + x_(t-m)
+ *
+ *        Nothing newer than m samples is fed back, so the block operator
+ *        computes up to m samples of products at once and only the
+ *        (noise shaped) rounding runs per sample.
+ *
+ */
+template <class T>
+class FixedAllPass : public Filter
+{
+public:
+
+  // ctor
+  FixedAllPass() : m(0), a(0), error(0) { }
+
+  void setCoefficient(double a_) { a = Fixed<T>::coefficient(a_); }
+
+  // keeps history like AllPass::setDelay
+  void setDelay(int m_)
+  {
+    m = m_ > 0 ? m_ : 0;
+
+    delayX.reserve(m);
+    delayY.reserve(m);
+  }
+
+  float operator()(float x) override
+  {
+    if (m <= 0)
+      return 0.0f;
+
+    T xq = Fixed<T>::fromFloat(x);
+
+    int64_t acc = a * xq - a * delayY.read(m) + (int64_t)delayX.read(m) * (1LL << Fixed<T>::coeffBits);
+
+    T y = Fixed<T>::requantize(acc, error);
+
+    delayX.write(xq);
+    delayY.write(y);
+
+    return Fixed<T>::toFloat(y);
+  }
+
+  void process(float* samples, int numSamples) override
+  {
+    if (m <= 0)
+    {
+      for (int i = 0; i < numSamples; ++i)
+        samples[i] = 0.0f;
+      return;
+    }
+
+    T x[blockSize], xM[blockSize], yM[blockSize], y[blockSize];
+    typename FixedFormat<T>::Acc u[blockSize];
+
+    const int chunk = m < blockSize ? m : blockSize;
+    const int64_t one = 1LL << Fixed<T>::coeffBits;
+
+    for (int start = 0; start < numSamples; start += chunk)
+    {
+      int n = numSamples - start < chunk ? numSamples - start : chunk;
+      float* s = samples + start;
+
+      for (int i = 0; i < n; ++i)
+        x[i] = Fixed<T>::fromFloat(s[i]);
+
+      delayX.readBlock(m, xM, n);
+      delayY.readBlock(m, yM, n);
+
+      fixedMultiplyAdd(x, yM, xM, a, -a, one, u, n);
+
+      for (int i = 0; i < n; ++i)
+      {
+        y[i] = Fixed<T>::requantize(u[i], error);
+        s[i] = Fixed<T>::toFloat(y[i]);
+      }
+
+      delayX.writeBlock(x, n);
+      delayY.writeBlock(y, n);
+    }
+  }
+
+private:
+
+  // samples converted per pass of the block operator
+  static const int blockSize = 256;
+
+  // delay value (in samples)
+  int m;
+
+  // fixed point coeff
+  int64_t a;
+
+  // x/y delay lines
+  FixedDelayLine<T> delayX;
+  FixedDelayLine<T> delayY;
+
+  // rounding error carried to the next sample
+  int64_t error;
+};
+
+// 16 bit filters (Q3.12 samples in an int16) and 32 bit filters (Q3.28 in an
+// int32). Not Q15/Q31: the 3 integer bits are headroom for comb peaks, paid
+// for with 3 bits less resolution at the quiet end of a tail.
+typedef FixedLowPass<int16_t> LowPassQ3_12;
+typedef FixedLowPass<int32_t> LowPassQ3_28;
+typedef FixedLowPassComb<int16_t> LowPassCombQ3_12;
+typedef FixedLowPassComb<int32_t> LowPassCombQ3_28;
+typedef FixedAllPass<int16_t> AllPassQ3_12;
+typedef FixedAllPass<int32_t> AllPassQ3_28;
@@ -0,0 +1,282 @@
+/**
+ * @file   Followers.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the envelope and pitch followers
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "Followers.h"
+#include "Denormals.h"
+#include <cmath>
+
+/**
+ * @brief Recomputes attack/release one pole coefficients, each reaches
+ *        ~63% of a step in its time
+ * 
+ */
+void EnvelopeFollower::updateCoefficients()
+{
+  attack = attackMs > 0.0 ? std::exp(-1000.0 / (attackMs * sr)) : 0.0;
+  release = releaseMs > 0.0 ? std::exp(-1000.0 / (releaseMs * sr)) : 0.0;
+  average = rmsMs > 0.0 ? std::exp(-1000.0 / (rmsMs * sr)) : 0.0;
+}
+
+/**
+ * @brief Block envelope follower, rectification is done over the whole
+ *        block first (vectorizable), then the attack/release smoothing
+ * 
+ * @param in  input samples
+ * @param env envelope output (may be the same as in)
+ * @param n   number of samples
+ */
+void EnvelopeFollower::process(const float* in, float* env, int n)
+{
+  ScopedFlushToZero ftz;
+
+  if (mode == Peak)
+  {
+    for (int i = 0; i < n; ++i)
+      env[i] = std::fabs(in[i]);
+  }
+  else
+  {
+    for (int i = 0; i < n; ++i)
+      env[i] = in[i] * in[i];
+
+    // running mean square
+    double m = ms1;
+    for (int i = 0; i < n; ++i)
+    {
+      m = env[i] + average * (m - env[i]);
+      env[i] = (float)m;
+    }
+    ms1 = m;
+
+    for (int i = 0; i < n; ++i)
+      env[i] = std::sqrt(env[i]);
+  }
+
+  double y = y1;
+
+  for (int i = 0; i < n; ++i)
+  {
+    double x = env[i];
+    double c = x > y ? attack : release;
+
+    y = x + c * (y - x);
+    env[i] = (float)y;
+  }
+
+  y1 = y;
+}
+
+/**
+ * @brief Gets the most recent envelope value
+ * 
+ * @return float 
+ */
+float EnvelopeFollower::getEnvelope() const
+{
+  return (float)y1;
+}
+
+/**
+ * @brief In place radix-2 FFT
+ * 
+ * @param data     size N (power of 2)
+ * @param twiddles e^(-2 pi i k / N) for k < N / 2
+ * @param inverse  run inverse transform (unscaled)
+ */
+static void fft(std::complex<double>* data, const std::complex<double>* twiddles, int N, bool inverse)
+{
+  // bit reversal
+  for (int i = 1, j = 0; i < N; ++i)
+  {
+    int bit = N >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+
+    if (i < j)
+      std::swap(data[i], data[j]);
+  }
+
+  for (int len = 2; len <= N; len <<= 1)
+  {
+    int step = N / len;
+
+    for (int i = 0; i < N; i += len)
+    {
+      for (int k = 0; k < len / 2; ++k)
+      {
+        std::complex<double> w = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+        std::complex<double> u = data[i + k];
+        std::complex<double> v = data[i + k + len / 2] * w;
+
+        data[i + k] = u + v;
+        data[i + k + len / 2] = u - v;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Allocates every buffer the tracker needs, so process never does
+ * 
+ * @param sampleRate sampling rate
+ * @param windowSize analysis window (power of 2), lowest pitch is rate / window
+ * @param hopSize    samples between analyses
+ */
+void PitchTracker::prepare(double sampleRate, int windowSize, int hopSize)
+{
+  sr = sampleRate;
+
+  // round window up to a power of 2
+  window = 1;
+  while (window < windowSize)
+    window <<= 1;
+
+  hop = hopSize > 0 ? hopSize : window / 8;
+
+  const int N = 2 * window;
+
+  history.assign(N, 0.0f);
+  spectrum.assign(N, 0.0);
+  diff.assign(window, 0.0);
+
+  twiddles.resize(N / 2);
+  for (int k = 0; k < N / 2; ++k)
+    twiddles[k] = std::polar(1.0, -2.0 * 3.14159265358979323846 * k / N);
+
+  writePos = 0;
+  filled = 0;
+  sinceHop = 0;
+  frequency = 0.0f;
+  confidence = 0.0f;
+}
+
+/**
+ * @brief Feeds input samples, running an analysis every hop once the
+ *        history is full
+ * 
+ * @param in input samples
+ * @param n  number of samples
+ */
+void PitchTracker::process(const float* in, int n)
+{
+  const int N = (int)history.size();
+
+  for (int i = 0; i < n; ++i)
+  {
+    history[writePos] = in[i];
+    if (++writePos == N)
+      writePos = 0;
+
+    if (filled < N)
+      ++filled;
+
+    if (++sinceHop >= hop && filled == N)
+    {
+      sinceHop = 0;
+      analyse();
+    }
+  }
+}
+
+/**
+ * @brief YIN on the last 2 * window samples
+ *
+ *   d(tau)  = sum_j (x_j - x_(j+tau))^2 = E(0) + E(tau) - 2r(tau)
+ *   r(tau)  = sum_j x_j x_(j+tau)   <-- from IFFT(conj(A)B)
+ *   d'(tau) = d(tau) * tau / sum_(1..tau) d
+ *
+ *   pitch = rate / (first dip of d' under the threshold)
+ * 
+ */
+void PitchTracker::analyse()
+{
+  const int N = 2 * window;
+
+  // pack a (first window, zero padded) as real and b (whole history) as
+  // imaginary so both spectra come out of one fft
+  for (int j = 0; j < N; ++j)
+  {
+    double x = history[(writePos + j) % N];
+    spectrum[j] = std::complex<double>(j < window ? x : 0.0, x);
+  }
+
+  fft(spectrum.data(), twiddles.data(), N, false);
+
+  // split spectra, C = conj(A)B, computed in pairs (k, N - k)
+  for (int k = 0; k <= N / 2; ++k)
+  {
+    std::complex<double> z = spectrum[k];
+    std::complex<double> zn = std::conj(spectrum[(N - k) % N]);
+
+    std::complex<double> A = 0.5 * (z + zn);
+    std::complex<double> B = std::complex<double>(0.0, -0.5) * (z - zn);
+    std::complex<double> C = std::conj(A) * B;
+
+    spectrum[k] = C;
+    if (k > 0 && k < N / 2)
+      spectrum[N - k] = std::conj(C);
+  }
+
+  fft(spectrum.data(), twiddles.data(), N, true);
+
+  // energies of the first window, and of the window starting at tau
+  double e0 = 0.0;
+  for (int j = 0; j < window; ++j)
+  {
+    double x = history[(writePos + j) % N];
+    e0 += x * x;
+  }
+
+  double etau = e0;
+  double runningSum = 0.0;
+  diff[0] = 1.0;
+
+  for (int tau = 1; tau < window; ++tau)
+  {
+    double xOut = history[(writePos + tau - 1) % N];
+    double xIn = history[(writePos + tau + window - 1) % N];
+    etau += xIn * xIn - xOut * xOut;
+
+    double d = e0 + etau - 2.0 * spectrum[tau].real() / N;
+    d = d < 0.0 ? 0.0 : d;
+
+    runningSum += d;
+    diff[tau] = runningSum > 0.0 ? d * tau / runningSum : 1.0;
+  }
+
+  // first dip under threshold, followed down to its minimum
+  int best = 0;
+  for (int tau = 2; tau < window - 1; ++tau)
+  {
+    if (diff[tau] < threshold)
+    {
+      while (tau + 1 < window - 1 && diff[tau + 1] < diff[tau])
+        ++tau;
+
+      best = tau;
+      break;
+    }
+  }
+
+  if (!best)
+  {
+    frequency = 0.0f;
+    confidence = 0.0f;
+    return;
+  }
+
+  // parabolic interpolation around the dip
+  double a = diff[best - 1], b = diff[best], c = diff[best + 1];
+  double denom = a - 2.0 * b + c;
+  double shift = denom != 0.0 ? 0.5 * (a - c) / denom : 0.0;
+
+  frequency = (float)(sr / (best + shift));
+  confidence = (float)(1.0 - b);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file   Followers.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Audio rate envelope and pitch followers, used as Pd externals
+ *         and as a sidechain for MoorerReverb
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include <vector>
+#include <complex>
+
+/**
+ * @brief Peak or RMS envelope follower with separate attack/release
+ * 
+ *   X                                                             Y
+ *  ---> | |x| | -------------------------------> | attack/release | --->  (peak)
+ *  ---> | x^2 | ---> | mean (rms window) | -> sqrt ---^                   (rms)
+ *
+ *   yt = x + c(y_(t-1) - x), c = attack coeff if x > y_(t-1), else release
+ * 
+ */
+class EnvelopeFollower
+{
+public:
+
+  enum Mode { Peak, RMS };
+
+  // ctor
+  EnvelopeFollower() : mode(Peak), sr(48000.0), attackMs(10.0), releaseMs(100.0), rmsMs(20.0), y1(0.0), ms1(0.0)
+  { 
+    updateCoefficients(); 
+  }
+
+  void setRate(double sampleRate) { sr = sampleRate; updateCoefficients(); }
+  void setMode(Mode m) { mode = m; }
+  void setAttack(double ms) { attackMs = ms; updateCoefficients(); }
+  void setRelease(double ms) { releaseMs = ms; updateCoefficients(); }
+
+  // averaging time of the mean square in RMS mode
+  void setRmsWindow(double ms) { rmsMs = ms; updateCoefficients(); }
+
+  void reset() { y1 = 0.0; ms1 = 0.0; }
+
+  // settings and past values (plain data, written out as is)
+  struct State
+  {
+    int mode, pad;
+    double attackMs, releaseMs, rmsMs, y1, ms1;
+  };
+
+  State getState() const { return { (int)mode, 0, attackMs, releaseMs, rmsMs, y1, ms1 }; }
+
+  // restores a state from getState (coefficients are rederived at current rate)
+  void setState(const State& s)
+  {
+    mode = s.mode == RMS ? RMS : Peak;
+    attackMs = s.attackMs;
+    releaseMs = s.releaseMs;
+    rmsMs = s.rmsMs;
+    updateCoefficients();
+    y1 = s.y1;
+    ms1 = s.ms1;
+  }
+
+  // writes the envelope of n input samples to env (env may be in)
+  void process(const float* in, float* env, int n);
+
+  // last envelope value
+  float getEnvelope() const;
+
+private:
+
+  void updateCoefficients();
+
+  Mode mode;
+  double sr, attackMs, releaseMs, rmsMs;
+
+  // one pole coefficients, past envelope and past mean square
+  double attack, release, average, y1, ms1;
+};
+
+/**
+ * @brief YIN pitch tracker, difference function computed with an FFT
+ *        (autocorrelation) so a full analysis is O(W log W), run every hop
+ *        samples on the most recent window
+ * 
+ */
+class PitchTracker
+{
+public:
+
+  // ctor
+  PitchTracker() : sr(48000.0), window(0), hop(0), filled(0), sinceHop(0), threshold(0.15),
+                   frequency(0.0f), confidence(0.0f), writePos(0) { }
+
+  // allocates all analysis memory, window/hop in samples (window power of 2)
+  void prepare(double sampleRate, int windowSize = 1024, int hopSize = 128);
+
+  // YIN threshold, lower is stricter (0.1 - 0.2 are typical)
+  void setThreshold(double t) { threshold = t; }
+
+  // feeds n samples, analysing whenever a hop completes
+  void process(const float* in, int n);
+
+  // last detected frequency in hz (0 if unpitched) and confidence (0 - 1)
+  float getFrequency() const { return frequency; }
+  float getConfidence() const { return confidence; }
+
+private:
+
+  // runs one YIN analysis on the history buffer
+  void analyse();
+
+  double sr;
+
+  // analysis window, hop, samples seen, samples since last analysis
+  int window, hop, filled, sinceHop;
+
+  double threshold;
+
+  float frequency, confidence;
+
+  // ring of the last 2 * window input samples, and its write index
+  std::vector<float> history;
+  int writePos;
+
+  // fft work buffer + twiddles (size 2 * window)
+  std::vector<std::complex<double>> spectrum, twiddles;
+
+  // difference and cumulative mean normalized difference functions
+  std::vector<double> diff;
+};
@@ -0,0 +1,204 @@
+/**
+ * @file   LongDelay.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the tiered long delay line
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "LongDelay.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(_MSC_VER)
+  #include <xmmintrin.h>
+  #define LONGDELAY_PREFETCH(p) _mm_prefetch((const char*)(p), _MM_HINT_T0)
+#else
+  #define LONGDELAY_PREFETCH(p) __builtin_prefetch(p)
+#endif
+
+// how far ahead (in compact samples) reads prefetch, a few cache lines
+static const uint32_t prefetchAhead = 128;
+
+/**
+ * @brief Smallest power of 2 >= n
+ * 
+ */
+static uint32_t nextPow2(uint32_t n)
+{
+  uint32_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+/**
+ * @brief float -> IEEE half (round to nearest, no NaN payloads)
+ * 
+ */
+static uint16_t floatToHalf(float f)
+{
+  uint32_t x;
+  std::memcpy(&x, &f, sizeof(x));
+
+  uint32_t sign = (x >> 16) & 0x8000;
+  int32_t exponent = (int32_t)((x >> 23) & 0xff) - 127 + 15;
+  uint32_t mantissa = x & 0x7fffff;
+
+  // too small, flush to zero
+  if (exponent <= 0)
+    return (uint16_t)sign;
+
+  // too big (or inf/nan), clamp to inf
+  if (exponent >= 31)
+    return (uint16_t)(sign | 0x7c00);
+
+  uint32_t h = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+
+  // round to nearest (carry into exponent is fine)
+  if (mantissa & 0x1000)
+    ++h;
+
+  return (uint16_t)h;
+}
+
+/**
+ * @brief IEEE half -> float (denormal halves are read as zero)
+ * 
+ */
+static float halfToFloat(uint16_t h)
+{
+  uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+  uint32_t exponent = (h >> 10) & 0x1f;
+  uint32_t mantissa = h & 0x3ff;
+  uint32_t x;
+
+  if (exponent == 0)
+    x = sign;
+  else if (exponent == 31)
+    x = sign | 0x7f800000 | (mantissa << 13);
+  else
+    x = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+  float f;
+  std::memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+/**
+ * @brief Allocates the recent and compact rings
+ * 
+ * @param maxDelay      longest delay (samples)
+ * @param older         storage used beyond the recent window
+ * @param recentSamples size of the full precision window
+ * @param chunkSamples  samples packed at a time (power of 2, <= recentSamples)
+ */
+void LongDelayLine::prepare(int maxDelay, Storage older, int recentSamples, int chunkSamples)
+{
+  storage = older;
+  capacity = maxDelay;
+  chunkSize = nextPow2(chunkSamples > 0 ? chunkSamples : 1);
+
+  uint32_t recentSize = nextPow2(recentSamples > (int)chunkSize ? recentSamples : chunkSize);
+
+  if (storage == Full)
+  {
+    // everything stays in the recent ring
+    recentSize = nextPow2(maxDelay + 1 > (int)recentSize ? maxDelay + 1 : recentSize);
+    compact = std::vector<uint16_t>();
+    scales = std::vector<float>();
+    compactMask = 0;
+  }
+  else
+  {
+    // room for the max delay plus the chunk still being written
+    uint32_t compactSize = nextPow2(maxDelay + chunkSize);
+    compact.assign(compactSize, 0);
+    scales.assign(compactSize / chunkSize, 0.0f);
+    compactMask = compactSize - 1;
+  }
+
+  recent.assign(recentSize, 0.0f);
+  recentMask = recentSize - 1;
+  writeIndex = 0;
+}
+
+/**
+ * @brief Zeroes all history
+ * 
+ */
+void LongDelayLine::clear()
+{
+  std::fill(recent.begin(), recent.end(), 0.0f);
+  std::fill(compact.begin(), compact.end(), 0);
+  std::fill(scales.begin(), scales.end(), 0.0f);
+  writeIndex = 0;
+}
+
+/**
+ * @brief Gets the memory held by the line
+ * 
+ * @return size_t bytes
+ */
+size_t LongDelayLine::getMemoryBytes() const
+{
+  return recent.size() * sizeof(float) + compact.size() * sizeof(uint16_t) + scales.size() * sizeof(float);
+}
+
+/**
+ * @brief Packs one completed chunk. Int16 stores samples against the
+ *        chunk's peak (block floating point) so loud feedback doesn't clip
+ *        and quiet tails keep their resolution.
+ * 
+ * @param start absolute index of the chunk's first sample
+ */
+void LongDelayLine::packChunk(uint32_t start)
+{
+  const float* src = &recent[start & recentMask];
+  uint16_t* dst = &compact[start & compactMask];
+
+  if (storage == Half)
+  {
+    for (uint32_t i = 0; i < chunkSize; ++i)
+      dst[i] = floatToHalf(src[i]);
+    return;
+  }
+
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < chunkSize; ++i)
+  {
+    float a = std::fabs(src[i]);
+    peak = a > peak ? a : peak;
+  }
+
+  float scale = peak / 32767.0f;
+  float inverse = peak > 0.0f ? 32767.0f / peak : 0.0f;
+
+  for (uint32_t i = 0; i < chunkSize; ++i)
+    dst[i] = (uint16_t)(int16_t)std::lrint(src[i] * inverse);
+
+  scales[(start & compactMask) / chunkSize] = scale;
+}
+
+/**
+ * @brief Reads a packed sample, prefetching further along the compact ring
+ *        each time a new cache line is entered
+ * 
+ * @param i absolute index of sample
+ * 
+ * @return double 
+ */
+double LongDelayLine::readCompact(uint32_t i) const
+{
+  uint32_t c = i & compactMask;
+
+  // 32 samples per 64 byte line
+  if ((c & 31) == 0)
+    LONGDELAY_PREFETCH(&compact[(c + prefetchAhead) & compactMask]);
+
+  if (storage == Half)
+    return halfToFloat(compact[c]);
+
+  return (int16_t)compact[c] * scales[c / chunkSize];
+}
@@ -0,0 +1,113 @@
+/**
+ * @file   LongDelay.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Delay line for very long (multi minute) delays, keeping older
+ *         history in compact form
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Tiered delay line. The most recent samples live in a full precision
+ *        ring, and every completed chunk is also packed into a compact ring
+ *        (16 bit w/ a scale per chunk, or half floats), which serves every
+ *        read older than the recent window.
+ *
+ *   write ---> | recent (float) | ------------------------- read (d <= recent)
+ *                     |
+ *                     | (whole chunk at a time)
+ *                     v
+ *              | compact (16 bit) | ----------------------- read (d > recent)
+ *
+ *        Reads walk forward through the compact ring as time passes, so the
+ *        next few cache lines are prefetched as each one is entered.
+ * 
+ */
+class LongDelayLine
+{
+public:
+
+  // how history older than the recent window is stored
+  enum Storage { Full, Int16, Half };
+
+  // ctor
+  LongDelayLine() : storage(Int16), chunkSize(0), recentMask(0), compactMask(0), writeIndex(0), capacity(0) { }
+
+  // allocates memory for delays up to maxDelay samples (clears history)
+  void prepare(int maxDelay, Storage older = Int16, int recentSamples = 1 << 16, int chunkSamples = 1 << 12);
+
+  // same as prepare w/ defaults, only reallocates when growing (DelayLine interface)
+  void reserve(int size)
+  {
+    if (size > capacity)
+      prepare(size, storage);
+  }
+
+  // value written d samples ago (1 <= d <= capacity)
+  double read(int d) const
+  {
+    uint32_t i = writeIndex - (uint32_t)d;
+
+    if ((uint32_t)d <= recentMask + 1)
+      return recent[i & recentMask];
+
+    return readCompact(i);
+  }
+
+  // value written d samples ago, linearly interpolated (1 <= d < capacity)
+  double readLinear(double d) const
+  {
+    int whole = (int)d;
+    double a = read(whole);
+    return a + (d - whole) * (read(whole + 1) - a);
+  }
+
+  // pushes newest value into the line
+  void write(double v)
+  {
+    recent[writeIndex & recentMask] = (float)v;
+
+    // pack each chunk as soon as it's complete
+    if ((++writeIndex & (chunkSize - 1)) == 0 && storage != Full)
+      packChunk(writeIndex - chunkSize);
+  }
+
+  // zeroes all history
+  void clear();
+
+  int getCapacity() const { return capacity; }
+
+  // bytes of sample memory held by the line
+  size_t getMemoryBytes() const;
+
+private:
+
+  // packs chunk starting at absolute index start into the compact ring
+  void packChunk(uint32_t start);
+
+  // reads an already packed sample (w/ prefetch of upcoming lines)
+  double readCompact(uint32_t i) const;
+
+  Storage storage;
+  uint32_t chunkSize;
+
+  // ring masks (sizes are powers of 2), absolute write counter
+  uint32_t recentMask, compactMask;
+  uint32_t writeIndex;
+
+  int capacity;
+
+  // full precision recent window
+  std::vector<float> recent;
+
+  // packed older history, and per chunk scale (Int16 only)
+  std::vector<uint16_t> compact;
+  std::vector<float> scales;
+};
@@ -7,10 +7,42 @@
  * @date   2022-03-17
  * @brief  
  *
- * @note   Modified 2022-06-12
+ * @note   Modified 2026-10-19
  */
 
 #include "MoorerReverb.h"
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Checkpoint header, followed (at the next 64 byte boundary) by a
+ *        raw image of the delay arena. Filter states are written as is, so
+ *        checkpoints only move between builds sharing layout/endianness,
+ *        headerSize catches the obvious mismatches.
+ * 
+ */
+struct MoorerCheckpoint
+{
+  uint32_t magic, version, headerSize, active;
+  uint64_t arenaDoubles;
+  int32_t rate, arenaRate;
+  double wet, duckDepth;
+
+  int32_t activeCombs, runningCombs, combFade, pad;
+  double combGain[6], combTarget[6], combStep[6];
+
+  LowPassComb::State combs[6];
+  AllPassDiffuser::State diffuser;
+  EnvelopeFollower::State sidechain;
+};
+
+// "MRCK"
+static const uint32_t checkpointMagic = 0x4d52434b;
+static const uint32_t checkpointVersion = 3;
+
+// header size rounded up so the arena image stays cache line aligned
+static const size_t checkpointHeaderBytes =
+  (sizeof(MoorerCheckpoint) + DelayArena::alignment - 1) / DelayArena::alignment * DelayArena::alignment;
 
 /**
  * @brief 
@@ -31,11 +63,17 @@ static double lerpBetweenPlots(double x, double x1, double y1, double x2, double
  * @brief This initializes the filter to the recommended parameter values
  *        by James A. Moorer, originally noted in his publication,
  *        "About This Reverberation Business." g values are interpolated
- *        to fit values at 44.1khz sampling rate.
+ *        to fit values at 44.1khz sampling rate. Filters keep their
+ *        history through this, so calling it again at the same rate keeps
+ *        the tail, only a new rate clears it.
  * 
  */
 void MoorerReverb::initializeFilters()
 {
+  allocateDelays();
+  allocateBandDelays();
+  allocateFixedCombs();
+
   // l values
     // suggested is 50, 56, 61, 68, 72 and 78 ms (* 0.001 to get sec)
     // * rate 
@@ -59,13 +97,666 @@ void MoorerReverb::initializeFilters()
     lp_combs[i].setDelay(lVals[i]);
   }
 
-  // set allpass coefficient/delay
-  ap.setCoefficient(0.7);
+  // set allpass diffuser coefficient/delay (4 cascaded stages, first at 6ms)
+  diffuser.setStages(4, false);
+  diffuser.setCoefficient(0.7);
   // 6ms = .006 sec
-  ap.setDelay(std::round(0.006 * (double)rate));
+  diffuser.setDelay(std::round(0.006 * (double)rate));
   
   // wet to dry ratio
   setMix(wet);
+
+  sidechain.setRate(rate);
+  pitchGlide = 1.0 - std::exp(-1.0 / (pitchGlideSeconds * rate));
+
+  // history recorded at another rate would play back at the wrong pitch
+  if (rate != configuredRate)
+  {
+    reset();
+    pitch.prepare(rate, pitchWindow, pitchHop);
+    configuredRate = rate;
+  }
+
+  bandDelaysDirty = true;
+}
+
+/**
+ * @brief Sizes the arena for the max delay at the highest rate we expect,
+ *        then carves out every comb's and the diffuser's delay lines
+ * 
+ */
+void MoorerReverb::allocateDelays()
+{
+  int sizedRate = rate > maxRate ? rate : maxRate;
+  int maxL = (int)std::ceil(maxDelaySeconds * sizedRate);
+
+  // memory already fits, nothing to do
+  if (sizedRate <= arenaRate && arenaHugePages == hugePages)
+    return;
+
+  size_t total = AllPassDiffuser::memoryNeeded(maxL);
+  for (int i = 0; i < numCombs; ++i)
+    total += LowPassComb::memoryNeeded(maxL);
+
+  arena.allocate(total, hugePages);
+  arenaRate = sizedRate;
+  arenaHugePages = hugePages;
+
+  for (int i = 0; i < numCombs; ++i)
+    lp_combs[i].attach(arena, maxL);
+
+  diffuser.attach(arena, maxL);
+}
+
+/**
+ * @brief Gets a snapshot of every parameter
+ * 
+ * @return MoorerParameters 
+ */
+MoorerParameters MoorerReverb::getParameters()
+{
+  MoorerParameters p;
+
+  p.mix = wet;
+
+  for (int i = 0; i < numCombs; ++i)
+  {
+    // a comb pitch tuning moved still reports its own delay
+    int L = pitchTuning && lp_combs[i].L == pitchL[i] ? pitchBaseL[i] : lp_combs[i].L;
+
+    p.g[i] = lp_combs[i].g;
+    p.ratio[i] = lp_combs[i].ratio;
+    p.L[i] = L * 1000.0 / rate;
+  }
+
+  p.a = diffuser.getCoefficient();
+  p.m = diffuser.getDelay() * 1000.0 / rate;
+  p.stages = diffuser.getNumStages();
+  p.nested = diffuser.isNested();
+
+  return p;
+}
+
+/**
+ * @brief Applies a whole parameter set. Only what differs is reconfigured,
+ *        coefficients never touch delay memory and new delays read from
+ *        the existing history, so tails carry on.
+ * 
+ * @param p parameters (delays in ms)
+ */
+void MoorerReverb::applyParameters(const MoorerParameters& p)
+{
+  for (int i = 0; i < numCombs; ++i)
+  {
+    lp_combs[i].setCoefficients(p.ratio[i], p.g[i]);
+    lp_combs[i].setDelay((int)std::round(p.L[i] * 0.001 * rate));
+  }
+
+  diffuser.setStages(p.stages, p.nested);
+  diffuser.setCoefficient(p.a);
+  diffuser.setDelay((int)std::round(p.m * 0.001 * rate));
+
+  setMix(p.mix);
+}
+
+/**
+ * @brief Steps down to (or back up to) fewer combs and diffuser stages.
+ *        Comb gains fade to their new value, with the remaining combs
+ *        scaled by sqrt(6 / combs) to keep the tail's level, and combs
+ *        coming back are cleared first since their history is stale.
+ * 
+ * @param combs  combs to run (1 - 6)
+ * @param stages diffuser stages to run (cascaded diffusers only)
+ */
+void MoorerReverb::setQuality(int combs, int stages)
+{
+  combs = combs < 1 ? 1 : (combs > numCombs ? numCombs : combs);
+
+  int fade = (int)std::round(qualityFadeSeconds * rate);
+  fade = fade < 1 ? 1 : fade;
+
+  diffuser.setActiveStages(stages, fade);
+
+  if (combs == activeCombs)
+    return;
+
+  double gain = std::sqrt((double)numCombs / combs);
+
+  for (int c = 0; c < numCombs; ++c)
+  {
+    // idle comb coming back, drop its stale history
+    if (c >= runningCombs && c < combs)
+    {
+      lp_combs[c].clear();
+
+      for (int b = 0; b < numBands; ++b)
+        bandComb[b][c].clear();
+
+      fixedComb12[c].clear();
+      fixedComb28[c].clear();
+    }
+
+    combTarget[c] = c < combs ? gain : 0.0;
+    combStep[c] = (combTarget[c] - combGain[c]) / fade;
+  }
+
+  runningCombs = combs > runningCombs ? combs : runningCombs;
+  activeCombs = combs;
+  combFade = fade;
+}
+
+/**
+ * @brief Moves comb gains one sample along a quality fade, landing exactly on
+ *        the targets (and dropping faded out combs) when it ends
+ * 
+ */
+void MoorerReverb::stepCombFade()
+{
+  if (--combFade == 0)
+  {
+    for (int c = 0; c < numCombs; ++c)
+      combGain[c] = combTarget[c];
+
+    runningCombs = activeCombs;
+    return;
+  }
+
+  for (int c = 0; c < runningCombs; ++c)
+    combGain[c] += combStep[c];
+}
+
+/**
+ * @brief Turns sub-band mode on (2 - 4 bands) or off (1). Band combs follow
+ *        the fullband combs, delays are divided by the band's decimation so
+ *        echo times stay put in seconds, and damping is refit per band (see
+ *        syncBands). Band comb counts go back to their defaults.
+ * 
+ * @param bands number of bands
+ */
+void MoorerReverb::setSubbands(int bands)
+{
+  numBands = bands < 1 ? 1 : (bands > maxBands ? maxBands : bands);
+
+  // the lowest band carries the longest decay and keeps every comb, bands
+  // above it run fewer (their damping leaves them less late energy)
+  for (int b = 0; b < maxBands; ++b)
+    bandCombs[b] = b == 0 ? numCombs : (b == numBands - 1 ? 2 : 3);
+
+  allocateBandDelays();
+  resetBands();
+
+  bandDelaysDirty = true;
+}
+
+/**
+ * @brief Sets a band's decay scale (applied to every comb's ratio)
+ * 
+ * @param band  band (0 is lowest)
+ * @param scale ratio scale (0 - 1, 1 follows the fullband settings)
+ */
+void MoorerReverb::setBandDecay(int band, double scale)
+{
+  if (band < 0 || band >= maxBands)
+    return;
+
+  bandDecay[band] = scale;
+  bandCoeffsDirty = true;
+}
+
+/**
+ * @brief Sets how many combs a band runs, combs coming back are cleared
+ * 
+ * @param band  band (0 is lowest)
+ * @param combs combs to run (1 - 6)
+ */
+void MoorerReverb::setBandCombs(int band, int combs)
+{
+  if (band < 0 || band >= maxBands)
+    return;
+
+  combs = combs < 1 ? 1 : (combs > numCombs ? numCombs : combs);
+
+  for (int c = bandCombs[band]; c < combs; ++c)
+    bandComb[band][c].clear();
+
+  bandCombs[band] = combs;
+}
+
+/**
+ * @brief Sizes the band arena for the max delay of every band (at its own
+ *        rate), then carves the band combs' delay lines. Memory is dropped
+ *        when sub-band mode is off.
+ * 
+ */
+void MoorerReverb::allocateBandDelays()
+{
+  if (numBands == 1)
+  {
+    bandArena.release();
+    bandArenaRate = bandArenaBands = 0;
+    return;
+  }
+
+  int sizedRate = rate > maxRate ? rate : maxRate;
+
+  // memory already fits, nothing to do
+  if (sizedRate <= bandArenaRate && numBands == bandArenaBands)
+    return;
+
+  int maxL[maxBands];
+  size_t total = 0;
+
+  for (int b = 0; b < numBands; ++b)
+  {
+    maxL[b] = (int)std::ceil(maxDelaySeconds * sizedRate / bandDecimation(b)) + 1;
+    total += numCombs * LowPassComb::memoryNeeded(maxL[b]);
+  }
+
+  bandArena.allocate(total, hugePages);
+  bandArenaRate = sizedRate;
+  bandArenaBands = numBands;
+
+  for (int b = 0; b < numBands; ++b)
+    for (int c = 0; c < numCombs; ++c)
+      bandComb[b][c].attach(bandArena, maxL[b]);
+
+  // freshly carved lines need their delays set again
+  bandDelaysDirty = true;
+}
+
+/**
+ * @brief Gain of a comb's damping lowpass (normalized to 1 at dc)
+ * 
+ *    |H(f)| = (1 - g) / |1 - g*e^(-j*2*pi*f)|
+ * 
+ * @param g lowpass coefficient
+ * @param f frequency (fraction of the rate)
+ * 
+ * @return double 
+ */
+static double dampingGain(double g, double f)
+{
+  return (1.0 - g) / std::sqrt(1.0 - 2.0 * g * std::cos(2.0 * 3.14159265358979323846 * f) + g * g);
+}
+
+/**
+ * @brief Derives every band comb from its fullband comb, only touching the
+ *        ones whose source changed (band lines keep their history through
+ *        delay changes, like they do fullband). Each band's loop gain
+ *        matches the fullband comb's at both band edges: the ratio takes
+ *        the damping at the lower edge, and g is refit so the band's own
+ *        lowpass falls to the fullband level at the upper edge.
+ * 
+ */
+void MoorerReverb::syncBands()
+{
+  for (int c = 0; c < numCombs; ++c)
+  {
+    const LowPassComb& src = lp_combs[c];
+    bool delayChanged = bandDelaysDirty || src.L != syncedL[c];
+
+    if (!delayChanged && !bandCoeffsDirty && src.ratio == syncedRatio[c] && src.g == syncedG[c])
+      continue;
+
+    for (int b = 0; b < numBands; ++b)
+    {
+      int d = bandDecimation(b);
+
+      // band edges (fraction of the full rate), band 0 starts at dc
+      double high = b == 0 ? 0.5 / d : 0.5 / (1 << (numBands - 1 - b));
+      double low = b == 0 ? 0.0 : 0.5 * high;
+
+      double lowGain = dampingGain(src.g, low);
+      double rho = dampingGain(src.g, high) / lowGain;
+
+      bandComb[b][c].setCoefficients(src.ratio * lowGain * bandDecay[b], (1.0 - rho) / (1.0 + rho));
+
+      if (delayChanged)
+      {
+        int l = (int)std::round((double)src.L / d);
+        bandComb[b][c].setDelay(l < 1 ? 1 : l);
+      }
+    }
+
+    syncedL[c] = src.L;
+    syncedRatio[c] = src.ratio;
+    syncedG[c] = src.g;
+  }
+
+  bandDelaysDirty = bandCoeffsDirty = false;
+}
+
+/**
+ * @brief Clears band delay memory, band comb feedback, the QMF tree and the
+ *        pending input, and refills the latency fifo with silence
+ * 
+ */
+void MoorerReverb::resetBands()
+{
+  bandArena.reset();
+
+  for (int b = 0; b < maxBands; ++b)
+    for (int c = 0; c < numCombs; ++c)
+      bandComb[b][c].clearFeedback();
+
+  for (auto& q : qmf)
+    q.reset();
+
+  for (bool& f : bandFlip)
+    f = false;
+
+  carryCount = 0;
+  fifoCount = getSubbandLatency();
+  std::memset(bandFifo, 0, sizeof(bandFifo));
+}
+
+/**
+ * @brief Switches the comb arithmetic. Fixed combs are sized for the max
+ *        delay at the highest expected rate (so delay changes never
+ *        allocate), pick up every fullband comb's settings and start
+ *        silent.
+ * 
+ * @param format comb format
+ */
+void MoorerReverb::setCombFormat(CombFormat format)
+{
+  combFormat = format;
+
+  allocateFixedCombs();
+  clearFixedCombs();
+  syncFixedCombs();
+}
+
+/**
+ * @brief Sizes the selected fixed combs' lines like allocateDelays sizes the
+ *        arena (lines only grow, so this is free once they fit)
+ * 
+ */
+void MoorerReverb::allocateFixedCombs()
+{
+  if (combFormat == DoubleCombs)
+    return;
+
+  int sizedRate = rate > maxRate ? rate : maxRate;
+  int maxL = (int)std::ceil(maxDelaySeconds * sizedRate);
+
+  for (int c = 0; c < numCombs; ++c)
+  {
+    if (combFormat == FixedQ3_12)
+      fixedComb12[c].setMaxDelay(maxL);
+    else
+      fixedComb28[c].setMaxDelay(maxL);
+  }
+}
+
+/**
+ * @brief Copies a fullband comb's delay and coefficients to a fixed comb,
+ *        only what changed (coefficients are requantized on every set)
+ * 
+ * @param fixed fixed point comb
+ * @param src   fullband comb it follows
+ */
+template <class Comb>
+static void followComb(Comb& fixed, const LowPassComb& src)
+{
+  if (fixed.L != src.L)
+    fixed.setDelay(src.L);
+
+  if (fixed.ratio != src.ratio || fixed.g != src.g)
+    fixed.setCoefficients(src.ratio, src.g);
+}
+
+/**
+ * @brief Brings the selected fixed combs up to the fullband comb settings
+ * 
+ */
+void MoorerReverb::syncFixedCombs()
+{
+  for (int c = 0; c < numCombs; ++c)
+  {
+    if (combFormat == FixedQ3_12)
+      followComb(fixedComb12[c], lp_combs[c]);
+    else if (combFormat == FixedQ3_28)
+      followComb(fixedComb28[c], lp_combs[c]);
+  }
+}
+
+/**
+ * @brief Zeroes both fixed comb banks (lines that were never allocated cost
+ *        nothing)
+ * 
+ */
+void MoorerReverb::clearFixedCombs()
+{
+  for (int c = 0; c < numCombs; ++c)
+  {
+    fixedComb12[c].clear();
+    fixedComb28[c].clear();
+  }
+}
+
+/**
+ * @brief Settles pitch tuning at the start of a block. A delay that isn't
+ *        the one tuning last set was set from outside (parameters, ui) and
+ *        becomes the comb's own, the glide carries on from it. When tuning
+ *        stops every comb goes straight back to its own delay.
+ * 
+ * @param tuning whether this block tunes
+ */
+void MoorerReverb::syncPitchTuning(bool tuning)
+{
+  if (!tuning && !pitchTuning)
+    return;
+
+  for (int c = 0; c < numCombs; ++c)
+  {
+    if (!pitchTuning || lp_combs[c].L != pitchL[c])
+    {
+      pitchBaseL[c] = lp_combs[c].L;
+      pitchPos[c] = pitchBaseL[c];
+    }
+
+    if (!tuning)
+      lp_combs[c].setDelay(pitchBaseL[c]);
+
+    pitchL[c] = lp_combs[c].L;
+  }
+
+  pitchTuning = tuning;
+}
+
+/**
+ * @brief Pitch tuning, one sample. The tracker's period sets each comb's
+ *        target (its own delay moved depth of the way to the nearest whole
+ *        number of periods), the delay follows it through a one pole glide
+ *        and the comb only changes when the rounded delay does.
+ * 
+ *   target = L0 + depth * (round(L0 / T) * T - L0),  T = rate / f
+ * 
+ * @param sidechainSample sidechain input
+ */
+void MoorerReverb::stepPitchTuning(float sidechainSample)
+{
+  pitch.process(&sidechainSample, 1);
+
+  const double f = pitch.getFrequency();
+  const double period = f > 0.0 ? rate / f : 0.0;
+
+  for (int c = 0; c < numCombs; ++c)
+  {
+    const double base = pitchBaseL[c];
+    double target = base;
+
+    if (period > 0.0)
+    {
+      double periods = std::round(base / period);
+      target = base + pitchDepth * ((periods < 1.0 ? 1.0 : periods) * period - base);
+    }
+
+    pitchPos[c] += pitchGlide * (target - pitchPos[c]);
+
+    int l = (int)std::lround(pitchPos[c]);
+    if (l != pitchL[c])
+    {
+      lp_combs[c].setDelay(l < 1 ? 1 : l);
+      pitchL[c] = lp_combs[c].L;
+    }
+  }
+}
+
+/**
+ * @brief Bytes needed by saveCheckpoint
+ * 
+ * @return size_t 
+ */
+size_t MoorerReverb::getCheckpointSize() const
+{
+  return checkpointHeaderBytes + arena.getUsed() * sizeof(double);
+}
+
+/**
+ * @brief Writes the complete dsp state (parameters, past values, positions
+ *        and every delay line) as one contiguous image
+ * 
+ * @param dest destination memory
+ * @param size bytes available at dest
+ * 
+ * @return true if the checkpoint was written
+ */
+bool MoorerReverb::saveCheckpoint(void* dest, size_t size) const
+{
+  if (!dest || size < getCheckpointSize() || numBands > 1 || combFormat != DoubleCombs || pitchTuning)
+    return false;
+
+  // zero the whole header first so padding is deterministic
+  unsigned char* bytes = static_cast<unsigned char*>(dest);
+  std::memset(bytes, 0, checkpointHeaderBytes);
+
+  MoorerCheckpoint h;
+  std::memset(&h, 0, sizeof(h));
+
+  h.magic = checkpointMagic;
+  h.version = checkpointVersion;
+  h.headerSize = sizeof(MoorerCheckpoint);
+  h.active = isActive ? 1 : 0;
+  h.arenaDoubles = arena.getUsed();
+  h.rate = rate;
+  h.arenaRate = arenaRate;
+  h.wet = wet;
+  h.duckDepth = duckDepth;
+  h.activeCombs = activeCombs;
+  h.runningCombs = runningCombs;
+  h.combFade = combFade;
+
+  for (int i = 0; i < numCombs; ++i)
+  {
+    h.combs[i] = lp_combs[i].getState();
+    h.combGain[i] = combGain[i];
+    h.combTarget[i] = combTarget[i];
+    h.combStep[i] = combStep[i];
+  }
+
+  h.diffuser = diffuser.getState();
+  h.sidechain = sidechain.getState();
+
+  std::memcpy(bytes, &h, sizeof(h));
+
+  if (h.arenaDoubles)
+    std::memcpy(bytes + checkpointHeaderBytes, arena.data(), h.arenaDoubles * sizeof(double));
+
+  return true;
+}
+
+/**
+ * @brief Restores a checkpoint from saveCheckpoint. Filter states are
+ *        restored first, then the arena image is copied over every delay
+ *        line in one go.
+ * 
+ * @param src  checkpoint image
+ * @param size bytes available at src
+ * 
+ * @return true if the checkpoint was restored
+ */
+bool MoorerReverb::loadCheckpoint(const void* src, size_t size)
+{
+  if (!src || size < checkpointHeaderBytes)
+    return false;
+
+  const unsigned char* bytes = static_cast<const unsigned char*>(src);
+
+  MoorerCheckpoint h;
+  std::memcpy(&h, bytes, sizeof(h));
+
+  if (h.magic != checkpointMagic || h.version != checkpointVersion || h.headerSize != sizeof(MoorerCheckpoint))
+    return false;
+
+  if (h.rate <= 0 || h.arenaRate < h.rate || size < checkpointHeaderBytes + h.arenaDoubles * sizeof(double))
+    return false;
+
+  // delay memory has to be carved exactly like it was when saved
+  rate = configuredRate = h.rate;
+  maxRate = h.arenaRate;
+  if (arenaRate != h.arenaRate)
+    arenaRate = 0;
+
+  allocateDelays();
+
+  if (arena.getUsed() != h.arenaDoubles)
+    return false;
+
+  for (int i = 0; i < numCombs; ++i)
+  {
+    lp_combs[i].setState(h.combs[i]);
+    combGain[i] = h.combGain[i];
+    combTarget[i] = h.combTarget[i];
+    combStep[i] = h.combStep[i];
+  }
+
+  activeCombs = h.activeCombs < 1 || h.activeCombs > numCombs ? numCombs : h.activeCombs;
+  runningCombs = h.runningCombs < activeCombs || h.runningCombs > numCombs ? numCombs : h.runningCombs;
+  combFade = h.combFade > 0 ? h.combFade : 0;
+
+  diffuser.setState(h.diffuser);
+
+  sidechain.setRate(rate);
+  sidechain.setState(h.sidechain);
+  pitchGlide = 1.0 - std::exp(-1.0 / (pitchGlideSeconds * rate));
+  pitch.prepare(rate, pitchWindow, pitchHop);
+  pitchTuning = false;
+
+  setMix(h.wet);
+  duckDepth = h.duckDepth;
+  isActive = h.active != 0;
+
+  if (h.arenaDoubles)
+    std::memcpy(arena.data(), bytes + checkpointHeaderBytes, h.arenaDoubles * sizeof(double));
+
+  // checkpoints hold the fullband double combs, bands and fixed combs
+  // restart from silence
+  if (numBands > 1)
+    resetBands();
+
+  allocateFixedCombs();
+  clearFixedCombs();
+
+  return true;
+}
+
+/**
+ * @brief Clears all delay lines and feedback state, parameters are kept
+ * 
+ */
+void MoorerReverb::reset()
+{
+  arena.reset();
+
+  for (int i = 0; i < numCombs; ++i)
+    lp_combs[i].clearFeedback();
+
+  if (numBands > 1)
+    resetBands();
+
+  clearFixedCombs();
 }
 
 /**
@@ -73,7 +764,7 @@ void MoorerReverb::initializeFilters()
  * 
  *         / --> | low comb | --> \       (6 low pass comb filters)
  *   X    / --->     ....     ---> \                                  Y
- *  ---> / ----> | "      " | --> [SUM] ---> | all pass | ---> [SUM] --->
+ *  ---> / ----> | "      " | --> [SUM] ---> | diffuser | ---> [SUM] --->
  *        |                                                       |
  *        |                    (clean signal)                     |
  *        -------------------------> *K ------------------------->| 
@@ -84,20 +775,317 @@ void MoorerReverb::initializeFilters()
  */
 float MoorerReverb::operator()(float x)
 {
-  // if bypass isn't set, process data
-  if (isActive)
+  // a block of one, keeps quality fades in one place
+  process(&x, 1);
+
+  return x;
+}
+
+/**
+ * @brief Block version of the Moorer reverb, comb sums are gathered into a
+ *        scratch block so the diffuser can run over the whole block at once
+ * 
+ * @param samples    samples to process (in place)
+ * @param numSamples number of samples
+ */
+void MoorerReverb::process(float* samples, int numSamples)
+{
+  process(samples, nullptr, numSamples);
+}
+
+/**
+ * @brief Block Moorer reverb with a sidechain, the wet gain follows
+ *        wet * (1 - depth * envelope) every sample (ducking) and the comb
+ *        delays follow the sidechain's pitch (pitch tuning)
+ * 
+ * @param samples     samples to process (in place)
+ * @param sidechainIn sidechain samples (nullptr to skip both)
+ * @param numSamples  number of samples
+ */
+void MoorerReverb::process(float* samples, const float* sidechainIn, int numSamples)
+{
+  run(samples, &samples, 1, sidechainIn, numSamples);
+}
+
+/**
+ * @brief Block Moorer reverb reading in once and writing the result to every
+ *        output (e.g. both channels of a mono -> stereo bus)
+ * 
+ * @param in         input samples (may be one of the outputs)
+ * @param outs       output channels
+ * @param numOuts    number of outputs
+ * @param numSamples number of samples
+ */
+void MoorerReverb::process(const float* in, float* const* outs, int numOuts, int numSamples)
+{
+  run(in, outs, numOuts, nullptr, numSamples);
+}
+
+/**
+ * @brief Double version of the multi output block operator, for hosts
+ *        running at double precision (no float conversions along the way)
+ * 
+ * @param in         input samples (may be one of the outputs)
+ * @param outs       output channels
+ * @param numOuts    number of outputs
+ * @param numSamples number of samples
+ */
+void MoorerReverb::process(const double* in, double* const* outs, int numOuts, int numSamples)
+{
+  run(in, outs, numOuts, nullptr, numSamples);
+}
+
+/**
+ * @brief Block kernel behind every process overload. Works through scratch
+ *        blocks: comb sums, the diffuser and the wet/dry mix all run over a
+ *        block that stays in cache, which is then written to each output.
+ * 
+ * @param in          input samples (may be one of the outputs)
+ * @param outs        output channels
+ * @param numOuts     number of outputs
+ * @param sidechainIn sidechain samples (nullptr to skip ducking and pitch
+ *                    tuning)
+ * @param numSamples  number of samples
+ */
+template <class Sample>
+void MoorerReverb::run(const Sample* in, Sample* const* outs, int numOuts, const float* sidechainIn, int numSamples)
+{
+  if (!isActive)
   {
-    double y = 0.0f;
+    for (int o = 0; o < numOuts; ++o)
+      if (outs[o] != in)
+        std::memcpy(outs[o], in, numSamples * sizeof(Sample));
+    return;
+  }
+
+  // callers outside of JUCE don't set the fpu mode for us
+  ScopedFlushToZero ftz;
 
-    for (int i = 0; i < numCombs; i++)
+  Sample combSum[blockSize];
+  float duck[blockSize];
+
+  const bool tuning = sidechainIn && pitchDepth > 0.0;
+  syncPitchTuning(tuning);
+
+  for (int start = 0; start < numSamples; start += blockSize)
+  {
+    int n = numSamples - start < blockSize ? numSamples - start : blockSize;
+    const Sample* x = in + start;
+
+    // band and fixed combs take their delays once per block
+    if (tuning && (numBands > 1 || combFormat != DoubleCombs))
     {
-      // sum all comb filter outputs 
-      y += lp_combs[i]((double)x);
+      for (int i = 0; i < n; ++i)
+        stepPitchTuning(sidechainIn[start + i]);
     }
-  
-    // apply allpass, and add the clean value
-    return ((dry * x) + (wet * ap(y)));
+
+    if (numBands > 1)
+      runSubbands(x, combSum, n);
+    else if (combFormat != DoubleCombs)
+      runFixedCombs(x, combSum, n);
+    else
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        double y = 0.0;
+
+        if (tuning)
+          stepPitchTuning(sidechainIn[start + i]);
+
+        // float path keeps the per comb rounding it always had
+        for (int c = 0; c < runningCombs; ++c)
+          y += combGain[c] * (Sample)lp_combs[c].tick(x[i]);
+
+        combSum[i] = (Sample)y;
+
+        // quality change in progress
+        if (combFade)
+          stepCombFade();
+      }
+    }
+
+    diffuser.process(combSum, n);
+
+    if (sidechainIn && duckDepth > 0.0)
+    {
+      sidechain.process(sidechainIn + start, duck, n);
+
+      for (int i = 0; i < n; ++i)
+      {
+        double env = duck[i] > 1.0f ? 1.0 : duck[i];
+        combSum[i] = (Sample)((dry * x[i]) + (wet * (1.0 - duckDepth * env) * combSum[i]));
+      }
+    }
+    else
+    {
+      for (int i = 0; i < n; ++i)
+        combSum[i] = (Sample)((dry * x[i]) + (wet * combSum[i]));
+    }
+
+    for (int o = 0; o < numOuts; ++o)
+      std::memcpy(outs[o] + start, combSum, n * sizeof(Sample));
+  }
+}
+
+/**
+ * @brief Runs a band's combs over its samples in place
+ * 
+ * @param band  band (0 is lowest)
+ * @param v     band samples
+ * @param count number of band samples
+ */
+void MoorerReverb::runBandCombs(int band, double* v, int count)
+{
+  int combs = bandCombs[band] < runningCombs ? bandCombs[band] : runningCombs;
+
+  // fewer combs than the rest of the reverb, keep the band's level
+  double level = bandCombs[band] < activeCombs ? std::sqrt((double)activeCombs / bandCombs[band]) : 1.0;
+
+  LowPassComb* bank = bandComb[band];
+
+  for (int i = 0; i < count; ++i)
+  {
+    // mirrored bands are flipped in and back out
+    double sign = bandFlip[band] ? -1.0 : 1.0;
+    bandFlip[band] = band > 0 && !bandFlip[band];
+
+    double sum = 0.0;
+
+    for (int c = 0; c < combs; ++c)
+      sum += combGain[c] * bank[c].tick(sign * v[i]);
+
+    v[i] = sign * level * sum;
+  }
+}
+
+/**
+ * @brief Sub-band comb sum. Input is gathered into groups (one lowest band
+ *        sample each), split down the QMF tree, run through each band's
+ *        combs at the band's rate, merged back up, and read out through a
+ *        fifo holding one group of latency, so any block size works.
+ * 
+ * @param x input samples
+ * @param y comb sums (before the diffuser)
+ * @param n number of samples (up to blockSize)
+ */
+template <class Sample>
+void MoorerReverb::runSubbands(const Sample* x, Sample* y, int n)
+{
+  syncBands();
+
+  const int group = getSubbandLatency();
+
+  // pending input + this block, whole groups only
+  double full[blockSize + maxDecimation];
+  double scratch[blockSize + maxDecimation];
+  double bands[maxBands][(blockSize + maxDecimation) / 2];
+
+  std::memcpy(full, bandCarry, carryCount * sizeof(double));
+  for (int i = 0; i < n; ++i)
+    full[carryCount + i] = x[i];
+
+  int total = carryCount + n;
+  int used = total / group * group;
+
+  carryCount = total - used;
+  std::memcpy(bandCarry, full + used, carryCount * sizeof(double));
+
+  // analysis, every level peels the top octave off what's left (low bands
+  // are written back over the input, the split never overwrites unread input)
+  int len = used;
+  for (int k = 0; k < numBands - 1; ++k)
+  {
+    double* low = k == numBands - 2 ? bands[0] : full;
+    qmf[k].split(full, low, bands[numBands - 1 - k], len / 2);
+    len /= 2;
+  }
+
+  // combs, whole bands at once unless a quality fade has to step every sample
+  if (!combFade)
+  {
+    for (int b = 0; b < numBands; ++b)
+      runBandCombs(b, bands[b], used / bandDecimation(b));
   }
   else
-     return x;
+  {
+    for (int g = 0; g < used / group; ++g)
+    {
+      for (int b = 0; b < numBands; ++b)
+      {
+        int perGroup = group / bandDecimation(b);
+        runBandCombs(b, bands[b] + g * perGroup, perGroup);
+      }
+
+      for (int i = 0; i < group && combFade; ++i)
+        stepCombFade();
+    }
+  }
+
+  // synthesis, back up the tree into the fifo (ping-ponging between the two
+  // full rate buffers, a merge can't run in place)
+  const double* low = bands[0];
+  double* out = full;
+  len = used >> (numBands - 1);
+
+  for (int k = numBands - 2; k >= 0; --k)
+  {
+    double* dest = k == 0 ? bandFifo + fifoCount : out;
+    qmf[k].merge(low, bands[numBands - 1 - k], dest, len);
+
+    low = dest;
+    out = out == full ? scratch : full;
+    len *= 2;
+  }
+
+  fifoCount += used;
+
+  for (int i = 0; i < n; ++i)
+    y[i] = (Sample)bandFifo[i];
+
+  fifoCount -= n;
+  std::memmove(bandFifo, bandFifo + n, fifoCount * sizeof(double));
+}
+
+/**
+ * @brief Fixed point comb sum. Each comb runs its block operator over a
+ *        float copy of the input, then the comb outputs are weighted per
+ *        sample so a quality fade steps exactly like it does for the double
+ *        combs.
+ * 
+ * @param x input samples
+ * @param y comb sums (before the diffuser)
+ * @param n number of samples (up to blockSize)
+ */
+template <class Sample>
+void MoorerReverb::runFixedCombs(const Sample* x, Sample* y, int n)
+{
+  syncFixedCombs();
+
+  float v[6][blockSize];
+  const int combs = runningCombs;
+
+  for (int c = 0; c < combs; ++c)
+  {
+    for (int i = 0; i < n; ++i)
+      v[c][i] = (float)x[i];
+
+    if (combFormat == FixedQ3_12)
+      fixedComb12[c].process(v[c], n);
+    else
+      fixedComb28[c].process(v[c], n);
+  }
+
+  for (int i = 0; i < n; ++i)
+  {
+    double sum = 0.0;
+
+    for (int c = 0; c < combs; ++c)
+      sum += combGain[c] * v[c][i];
+
+    y[i] = (Sample)sum;
+
+    // quality change in progress
+    if (combFade)
+      stepCombFade();
+  }
 }
@@ -4,15 +4,37 @@
  * @date   2022-03-17
  * @brief  
  *
- * @note   Modified 2022-06-12
+ * @note   Modified 2026-10-19
  */
 
 #pragma once
 
 #include "Filters.h"
+#include "FixedFilters.h"
+#include "Followers.h"
+#include "Subbands.h"
 #include <vector>
 #include <cmath>
 
+/**
+ * @brief Every user facing MoorerReverb parameter, plain data so whole
+ *        configurations can be stored, copied and prepared ahead of time
+ * 
+ */
+struct MoorerParameters
+{
+  // wet amount (0 - 1)
+  double mix;
+
+  // per comb lowpass coefficient, R / (1 - g) ratio and delay (ms)
+  double g[6], ratio[6], L[6];
+
+  // diffuser coefficient, first stage delay (ms), number of stages + topology
+  double a, m;
+  int stages;
+  bool nested;
+};
+
 /**
  * @brief Moorer reverb class
  * 
@@ -24,9 +46,25 @@ public:
   MoorerReverb() = default;
   MoorerReverb(int samplingRate, double mix_) : rate(samplingRate), isActive(true), wet(mix_) { initializeFilters(); }
 
+  MoorerReverb(const MoorerReverb&) = delete;
+  MoorerReverb& operator=(const MoorerReverb&) = delete;
+
   void initializeFilters();
+
+  // zeroes all reverb state (delay memory is cleared with one memset)
+  void reset();
   
   void setRate(int sr) { rate = sr; }
+
+  // delay memory is sized for the larger of this and the current rate, so
+  // rates up to maxRate never reallocate
+  void setMaxRate(int sr) { maxRate = sr; }
+
+  // back delay memory with huge pages (linux, takes effect on next allocation)
+  void setHugePages(bool enabled) { hugePages = enabled; }
+
+  // longest delay any comb or the diffuser can be set to (editor's 100ms)
+  static constexpr double maxDelaySeconds = 0.1;
   void setMix(double wet_) { wet = wet_; dry = 1.0 - wet_; }
   double getMix() { return wet; }
 
@@ -35,27 +73,241 @@ public:
     isActive = isActive ? false : true;
   }
 
+  bool isBypassed() { return !isActive; }
+
+  // gets current parameters (delays in ms)
+  MoorerParameters getParameters();
+
+  // applies a whole parameter set, reconfiguring only what changed and
+  // keeping tails (no delay memory is allocated as long as the rate hasn't
+  // changed since initializeFilters)
+  void applyParameters(const MoorerParameters& p);
+
+  // bytes a checkpoint takes (header + filter state + all delay memory)
+  size_t getCheckpointSize() const;
+
+  // writes the complete dsp state to dest as one contiguous image, false if
+  // it doesn't fit (or sub-band mode or fixed combs are on, their state
+  // isn't captured). Delay memory sits 64-byte aligned at the end of the
+  // image, so a checkpoint file can be mapped and restored from directly.
+  bool saveCheckpoint(void* dest, size_t size) const;
+
+  // restores a checkpoint bit exactly (delay memory is reallocated if it was
+  // taken at another rate), false if the image isn't valid for this build
+  bool loadCheckpoint(const void* src, size_t size);
+
+  // cpu scaling, runs only the first combs (level compensated) and the first
+  // stages of a cascaded diffuser, fading over a few ms. Delay memory is
+  // left alone, so this is safe to call from the audio thread.
+  void setQuality(int combs, int stages);
+
+  int getActiveCombs() { return activeCombs; }
+
+  // sub-band mode, splits the comb input into 2 - 4 octave bands with a QMF
+  // tree and runs a comb bank per band at the band's rate (top band at 1/2,
+  // the next at 1/4 ...), so each band's decay and comb count can be set on
+  // its own, 1 turns it off. Bands are critically sampled, so cpu is only
+  // saved by the bands running fewer combs (the QMF costs about what it
+  // saves otherwise). The wet path picks up a few samples of latency
+  // (getSubbandLatency). Allocates band delay memory, don't call from the
+  // audio thread.
+  void setSubbands(int bands);
+  int getSubbands() const { return numBands; }
+  int getSubbandLatency() const { return numBands > 1 ? 1 << (numBands - 1) : 0; }
+
+  // scales every comb's ratio (so the decay) within a band, band 0 is the
+  // lowest (1 follows the fullband settings)
+  void setBandDecay(int band, double scale);
+
+  // combs a band runs (1 - 6), the lowest band defaults to all 6, the top
+  // band to 2 since the damping leaves it little late energy, and the bands
+  // in between to 3
+  void setBandCombs(int band, int combs);
+
+  // comb arithmetic, double (default) or fixed point combs following the
+  // same settings, Q3.12 samples in 16 bit lines or Q3.28 in 32 bit lines
+  // (see FixedFilters.h). Fullband only, sub-band mode keeps running the
+  // double combs. Fixed combs start from silence. Allocates their delay
+  // lines, don't call from the audio thread.
+  enum CombFormat { DoubleCombs, FixedQ3_12, FixedQ3_28 };
+  void setCombFormat(CombFormat format);
+  CombFormat getCombFormat() const { return combFormat; }
+
+  // sets number of allpass stages used for diffusion, and their topology
+  void setDiffusion(int stages, bool nested) { diffuser.setStages(stages, nested); }
+
+  // ducks the wet signal by up to depth (0 - 1) as the sidechain envelope rises
+  void setDucking(double depth) { duckDepth = depth; }
+
+  // tunes the combs to the sidechain's pitch, each comb's delay glides
+  // depth (0 - 1, 0 is off) of the way to the nearest whole number of
+  // detected periods, so its resonances land on the note's harmonics, and
+  // back to its own delay while the sidechain is unpitched. New delays read
+  // from the existing history (like setDelay). Double combs move every
+  // sample, band and fixed combs once per block.
+  void setPitchTuning(double depth) { pitchDepth = depth; }
+
   float operator()(float x) override;
+  void process(float* samples, int numSamples) override;
+
+  // block operator w/ a sidechain input driving ducking and pitch tuning
+  // (nullptr for none)
+  void process(float* samples, const float* sidechainIn, int numSamples);
+
+  // block operators reading in once and writing every output (in may be one
+  // of the outputs), float and double
+  void process(const float* in, float* const* outs, int numOuts, int numSamples);
+  void process(const double* in, double* const* outs, int numOuts, int numSamples);
+
+  // sidechain envelope follower and pitch tracker (public to allow access
+  // to setters, the tracker is prepared at the reverb's rate with pitchHop)
+  EnvelopeFollower sidechain;
+  PitchTracker pitch;
 
   // filter objects (public to allow access to setters)
   LowPassComb lp_combs[6];
-  AllPass ap;
+  AllPassDiffuser diffuser;
   
   // sampling rate
-  int rate;
+  int rate = 48000;
 
 private:
 
+  // (re)allocates the arena if needed and carves every filter's delay lines
+  void allocateDelays();
+
+  // advances comb gains one sample through a quality fade
+  void stepCombFade();
+
+  // block kernel shared by every process overload
+  template <class Sample>
+  void run(const Sample* in, Sample* const* outs, int numOuts, const float* sidechainIn, int numSamples);
+
+  // sub-band version of the comb sum, n samples of x in, n comb sums out
+  template <class Sample>
+  void runSubbands(const Sample* x, Sample* y, int n);
+
+  // runs a band's comb bank over count band samples in place
+  void runBandCombs(int band, double* v, int count);
+
+  // sizes band delay memory for the current band count and rate
+  void allocateBandDelays();
+
+  // rederives band combs from the fullband combs if either changed
+  void syncBands();
+
+  // clears band delays, qmf state and the band latency fifo
+  void resetBands();
+
+  // fixed point version of the comb sum, n samples of x in, n comb sums out
+  template <class Sample>
+  void runFixedCombs(const Sample* x, Sample* y, int n);
+
+  // sizes the fixed combs' delay lines for the current rate
+  void allocateFixedCombs();
+
+  // copies fullband comb delays/coefficients that changed to the fixed combs
+  void syncFixedCombs();
+
+  // zeroes the fixed combs' lines and feedback
+  void clearFixedCombs();
+
+  // feeds one sidechain sample to the pitch tracker and moves every comb's
+  // delay one sample further along its glide
+  void stepPitchTuning(float sidechainSample);
+
+  // takes delays set since the last block as the combs' own, or puts the
+  // own delays back once tuning stops
+  void syncPitchTuning(bool tuning);
+
+  // rate divider of a band
+  int bandDecimation(int band) const { return 1 << (numBands - (band > 1 ? band : 1)); }
+
   // bool to control bypass of reverb effect
-  bool isActive;
-  
-  // if parameters have recently been updated
-  //bool isDirty;
+  bool isActive = true;
 
   // number of comb filters needed
   const int numCombs = 6;
 
+  // block size used for the comb -> diffuser scratch buffer
+  static const int blockSize = 256;
+
   // our wet/dry values
-  double wet, dry;
+  double wet = 0.2, dry = 0.8;
+
+  // how far the sidechain envelope can pull the wet signal down
+  double duckDepth = 0.0;
+
+  // tracker window and hop (samples), the glide is slow enough that an
+  // analysis every ~10ms does
+  static const int pitchWindow = 1024;
+  static const int pitchHop = 512;
+
+  // pitch tuning depth, per sample glide coefficient and its time constant,
+  // every comb's own delay, gliding delay and the delay last set from it,
+  // and whether tuning ran last block
+  static constexpr double pitchGlideSeconds = 0.05;
+  double pitchDepth = 0.0, pitchGlide = 1.0;
+  int pitchBaseL[6] = { }, pitchL[6] = { };
+  double pitchPos[6] = { };
+  bool pitchTuning = false;
+
+  // quality scaling, combs asked for and combs still running (fading out),
+  // per comb gain with its target and per sample step, samples of fade left
+  int activeCombs = 6, runningCombs = 6;
+  double combGain[6] = { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+  double combTarget[6] = { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+  double combStep[6] = { };
+  int combFade = 0;
+
+  // how long quality changes fade for
+  static constexpr double qualityFadeSeconds = 0.01;
+
+  // sub-band mode, band count, per band decay scale and comb count, band
+  // comb banks (band 0 lowest) and one QMF per octave split (0 splits
+  // full rate)
+  static const int maxBands = 4;
+  static const int maxDecimation = 1 << (maxBands - 1);
+  int numBands = 1;
+  double bandDecay[maxBands] = { 1.0, 1.0, 1.0, 1.0 };
+  int bandCombs[maxBands] = { 6, 6, 6, 6 };
+  LowPassComb bandComb[maxBands][6];
+  HalfbandQmf qmf[maxBands - 1];
+
+  // fullband comb settings the band combs were derived from, and whether
+  // every band delay/coefficient has to be derived again
+  int syncedL[6] = { };
+  double syncedRatio[6] = { }, syncedG[6] = { };
+  bool bandDelaysDirty = true, bandCoeffsDirty = true;
+
+  // sign of the next sample of every band above band 0 (the QMF leaves them
+  // mirrored, alternating signs puts them back in order for the combs)
+  bool bandFlip[maxBands] = { };
+
+  // input waiting to fill a group (one lowest band sample), and band output
+  // waiting to be read (the wet path's fixed latency)
+  double bandCarry[maxDecimation] = { };
+  int carryCount = 0;
+  double bandFifo[blockSize + 2 * maxDecimation] = { };
+  int fifoCount = 0;
+
+  // comb format, and the fixed point combs (only the selected format's
+  // lines are allocated)
+  CombFormat combFormat = DoubleCombs;
+  LowPassCombQ3_12 fixedComb12[6];
+  LowPassCombQ3_28 fixedComb28[6];
+
+  // band delay memory, and the rate/band count it's sized for
+  DelayArena bandArena;
+  int bandArenaRate = 0, bandArenaBands = 0;
+
+  // all comb/allpass delay memory, and the rate it's currently sized for
+  DelayArena arena;
+  int arenaRate = 0;
+
+  // rate the filters were last initialized at (their history belongs to it)
+  int configuredRate = 0;
+  int maxRate = 0;
+  bool hugePages = false, arenaHugePages = false;
 }; 
 
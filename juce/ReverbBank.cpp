@@ -0,0 +1,72 @@
+/**
+ * @file   ReverbBank.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the reverb bank
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "ReverbBank.h"
+
+/**
+ * @brief Creates every voice at the given rate
+ *
+ * @param numVoices number of voices
+ * @param rate_     sampling rate
+ */
+void MoorerReverbBank::prepare(int numVoices, int rate_)
+{
+  rate = rate_;
+  voices.clear();
+
+  for (int v = 0; v < numVoices; ++v)
+  {
+    voices.emplace_back(new MoorerReverb());
+    voices.back()->setRate(rate);
+    voices.back()->initializeFilters();
+  }
+}
+
+/**
+ * @brief Processes every voice in series
+ *
+ * @param voiceSamples one buffer per voice (processed in place)
+ * @param numSamples   samples per buffer
+ */
+void MoorerReverbBank::process(float* const* voiceSamples, int numSamples)
+{
+  for (size_t v = 0; v < voices.size(); ++v)
+    voices[v]->process(voiceSamples[v], numSamples);
+}
+
+/**
+ * @brief Processes every voice, each claimed by whichever core gets to it
+ *        first (this thread included)
+ *
+ * @param voiceSamples one buffer per voice (processed in place)
+ * @param numSamples   samples per buffer
+ * @param pool         pool to split the voices across
+ *
+ * @return true if the block finished within numSamples / rate
+ */
+bool MoorerReverbBank::process(float* const* voiceSamples, int numSamples, WorkerPool& pool)
+{
+  blockSamples = voiceSamples;
+  blockLength = numSamples;
+
+  return pool.run(&MoorerReverbBank::processVoice, this, (int)voices.size(), (double)numSamples / rate);
+}
+
+/**
+ * @brief Runs one voice of the current block
+ *
+ * @param context bank
+ * @param voice   voice index
+ */
+void MoorerReverbBank::processVoice(void* context, int voice)
+{
+  MoorerReverbBank* bank = static_cast<MoorerReverbBank*>(context);
+
+  bank->voices[voice]->process(bank->blockSamples[voice], bank->blockLength);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file   ReverbBank.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Bank of independent Moorer reverb voices, processed in series or
+ *         split across a WorkerPool
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include "MoorerReverb.h"
+#include "WorkerPool.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Many MoorerReverb voices run over their own buffers each block.
+ *        Voices share nothing, so a pool can hand them to any core, and
+ *        every voice lives in its own allocation (no two cores ever write
+ *        the same cache line).
+ *
+ */
+class MoorerReverbBank
+{
+public:
+
+  MoorerReverbBank() = default;
+
+  MoorerReverbBank(const MoorerReverbBank&) = delete;
+  MoorerReverbBank& operator=(const MoorerReverbBank&) = delete;
+
+  // (re)creates numVoices reverbs at rate with Moorer's defaults, allocates
+  // all delay memory (not real-time safe)
+  void prepare(int numVoices, int rate);
+
+  int getNumVoices() const { return (int)voices.size(); }
+
+  // voice access, for setting parameters between blocks
+  MoorerReverb& getVoice(int v) { return *voices[v]; }
+
+  // processes every voice over voiceSamples[v] in place, on this thread
+  void process(float* const* voiceSamples, int numSamples);
+
+  // same, with voices split between pool's workers and this thread. False
+  // if the block overran its length in time (see WorkerPool::run).
+  bool process(float* const* voiceSamples, int numSamples, WorkerPool& pool);
+
+private:
+
+  // pool job, one voice
+  static void processVoice(void* context, int voice);
+
+  std::vector<std::unique_ptr<MoorerReverb>> voices;
+  int rate = 48000;
+
+  // block being processed (read by pool jobs)
+  float* const* blockSamples = nullptr;
+  int blockLength = 0;
+};
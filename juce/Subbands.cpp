@@ -0,0 +1,189 @@
+/**
+ * @file   Subbands.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the half band QMF
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "Subbands.h"
+#include <cstring>
+
+// elliptic half band allpass coefficients (8 total, transition 0.04 of the
+// rate), section s pairs the even branch's 2s-th with the odd branch's
+alignas(16) static const double coefs[HalfbandQmf::numStages][2] =
+{
+  { 0.04063346092419326, 0.1505051290226746 },
+  { 0.3007570559918741,  0.4607745049614506 },
+  { 0.6095243148961883,  0.7385038411188573 },
+  { 0.8492238103920661,  0.9497427837050002 },
+};
+
+/**
+ * @brief Zeroes every section's past values
+ *
+ */
+void HalfbandQmf::reset()
+{
+  std::memset(splitX, 0, sizeof(splitX));
+  std::memset(splitY, 0, sizeof(splitY));
+  std::memset(mergeX, 0, sizeof(mergeX));
+  std::memset(mergeY, 0, sizeof(mergeY));
+}
+
+#if defined(SUBBANDS_USE_SSE2)
+
+/**
+ * @brief First order allpass sections, both branches at once (section state
+ *        is held in registers by the caller for the whole block)
+ *
+ *    yt = c*(xt - y_(t-1)) + x_(t-1)
+ *
+ * @param v even/odd branch samples
+ * @param c coefficients per section
+ * @param x past x per section
+ * @param y past y per section
+ *
+ * @return __m128d 
+ */
+static inline __m128d runStages(__m128d v, const __m128d* c, __m128d* x, __m128d* y)
+{
+  for (int s = 0; s < HalfbandQmf::numStages; ++s)
+  {
+    __m128d out = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(v, y[s]), c[s]), x[s]);
+    x[s] = v;
+    y[s] = out;
+    v = out;
+  }
+
+  return v;
+}
+
+/**
+ * @brief Runs pairs of samples through the sections, reading/writing each
+ *        pair through the given functions (state stays in registers)
+ *
+ * @param stateX   past x per section and lane
+ * @param stateY   past y per section and lane
+ * @param numPairs number of sample pairs
+ * @param load     makes the lanes of pair i
+ * @param store    writes the lanes of pair i
+ */
+template <class Load, class Store>
+static void runPairs(double stateX[][2], double stateY[][2], int numPairs, Load load, Store store)
+{
+  __m128d c[HalfbandQmf::numStages], x[HalfbandQmf::numStages], y[HalfbandQmf::numStages];
+
+  for (int s = 0; s < HalfbandQmf::numStages; ++s)
+  {
+    c[s] = _mm_load_pd(coefs[s]);
+    x[s] = _mm_load_pd(stateX[s]);
+    y[s] = _mm_load_pd(stateY[s]);
+  }
+
+  for (int i = 0; i < numPairs; ++i)
+  {
+    double lanes[2];
+    load(i, lanes);
+
+    __m128d v = runStages(_mm_loadu_pd(lanes), c, x, y);
+
+    _mm_storeu_pd(lanes, v);
+    store(i, lanes);
+  }
+
+  for (int s = 0; s < HalfbandQmf::numStages; ++s)
+  {
+    _mm_store_pd(stateX[s], x[s]);
+    _mm_store_pd(stateY[s], y[s]);
+  }
+}
+
+#else
+
+/**
+ * @brief Runs pairs of samples through the sections, reading/writing each
+ *        pair through the given functions
+ *
+ *    yt = c*(xt - y_(t-1)) + x_(t-1)
+ *
+ * @param x        past x per section and lane
+ * @param y        past y per section and lane
+ * @param numPairs number of sample pairs
+ * @param load     makes the lanes of pair i
+ * @param store    writes the lanes of pair i
+ */
+template <class Load, class Store>
+static void runPairs(double x[][2], double y[][2], int numPairs, Load load, Store store)
+{
+  for (int i = 0; i < numPairs; ++i)
+  {
+    double lanes[2];
+    load(i, lanes);
+
+    for (int s = 0; s < HalfbandQmf::numStages; ++s)
+    {
+      for (int l = 0; l < 2; ++l)
+      {
+        double out = coefs[s][l] * (lanes[l] - y[s][l]) + x[s][l];
+        x[s][l] = lanes[l];
+        y[s][l] = out;
+        lanes[l] = out;
+      }
+    }
+
+    store(i, lanes);
+  }
+}
+
+#endif
+
+/**
+ * @brief Analysis, the newer sample of each pair feeds the even branch and
+ *        the older one the odd branch, their sum/difference are the bands
+ *
+ * @param in       2 * numPairs input samples
+ * @param low      numPairs low band samples (half rate)
+ * @param high     numPairs high band samples (half rate, spectrum mirrored)
+ * @param numPairs number of sample pairs
+ */
+void HalfbandQmf::split(const double* in, double* low, double* high, int numPairs)
+{
+  runPairs(splitX, splitY, numPairs,
+    [in](int i, double* lanes)
+    {
+      lanes[0] = in[2 * i + 1];
+      lanes[1] = in[2 * i];
+    },
+    [low, high](int i, const double* lanes)
+    {
+      low[i] = 0.5 * (lanes[0] + lanes[1]);
+      high[i] = 0.5 * (lanes[0] - lanes[1]);
+    });
+}
+
+/**
+ * @brief Synthesis, recovers each branch from the bands and runs it through
+ *        the other branch's sections, so both samples of a pair end up
+ *        through the same allpass
+ *
+ * @param low      numPairs low band samples
+ * @param high     numPairs high band samples
+ * @param out      2 * numPairs output samples (can't be low or high)
+ * @param numPairs number of sample pairs
+ */
+void HalfbandQmf::merge(const double* low, const double* high, double* out, int numPairs)
+{
+  runPairs(mergeX, mergeY, numPairs,
+    [low, high](int i, double* lanes)
+    {
+      lanes[0] = low[i] - high[i];
+      lanes[1] = low[i] + high[i];
+    },
+    [out](int i, const double* lanes)
+    {
+      out[2 * i] = lanes[0];
+      out[2 * i + 1] = lanes[1];
+    });
+}
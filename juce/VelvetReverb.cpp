@@ -0,0 +1,260 @@
+/**
+ * @file   VelvetReverb.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the velvet noise reverb
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "VelvetReverb.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+/**
+ * @brief Places one pulse per grid cell (random spot, random sign), sorts
+ *        them into constant gain segments and normalizes the gains so an
+ *        impulse comes out of the tail at unit energy. The history is sized
+ *        so the oldest pulse still sees a whole block.
+ *
+ */
+void VelvetReverb::generatePulses()
+{
+  offsets.clear();
+  segments.clear();
+  maxOffset = 0;
+
+  const double spacing = density > 0.0 ? rate / density : 0.0;
+  const int tail = (int)((length > 0.0 ? length : decay) * rate);
+  const int pre = (int)std::round(predelay * 0.001 * rate);
+  const int segmentLength = std::max(1, (int)std::round(segmentSeconds * rate));
+
+  // raw generator output so a seed gives the same pattern everywhere
+  std::mt19937 rng(seed);
+  auto unit = [&rng]() { return rng() * (1.0 / 4294967296.0); };
+
+  std::vector<uint32_t> positive, negative;
+  double energy = 0.0;
+
+  for (int s = 0; spacing >= 1.0 && (double)s * segmentLength < tail; ++s)
+  {
+    positive.clear();
+    negative.clear();
+
+    // cells whose start falls in this segment
+    int firstCell = (int)std::ceil(s * segmentLength / spacing);
+    int endCell = (int)std::ceil(std::min((s + 1) * segmentLength, tail) / spacing);
+
+    for (int m = firstCell; m < endCell; ++m)
+    {
+      uint32_t offset = (uint32_t)(pre + (int)(m * spacing + unit() * (spacing - 1.0)));
+      (unit() < 0.5 ? negative : positive).push_back(offset);
+      maxOffset = std::max(maxOffset, offset);
+    }
+
+    Segment seg;
+    seg.begin = (int)offsets.size();
+    offsets.insert(offsets.end(), positive.begin(), positive.end());
+    seg.split = (int)offsets.size();
+    offsets.insert(offsets.end(), negative.begin(), negative.end());
+    seg.end = (int)offsets.size();
+
+    // decay at the middle of the segment, -60dB at the decay time
+    double t = (s + 0.5) * segmentLength / rate;
+    seg.gain = (float)std::pow(10.0, -3.0 * t / decay);
+    energy += (double)seg.gain * seg.gain * (seg.end - seg.begin);
+
+    if (seg.end > seg.begin)
+      segments.push_back(seg);
+  }
+
+  if (energy > 0.0)
+    for (Segment& seg : segments)
+      seg.gain = (float)(seg.gain / std::sqrt(energy));
+
+  capacity = (int)maxOffset + blockSize;
+  history.assign(2 * (size_t)capacity, 0.0f);
+  runs.assign(offsets.size(), nullptr);
+  writePos = 0;
+}
+
+/**
+ * @brief Clears the input history, the pulse index is kept
+ *
+ */
+void VelvetReverb::reset()
+{
+  std::fill(history.begin(), history.end(), 0.0f);
+  writePos = 0;
+}
+
+/**
+ * @brief Gather-accumulate over the pulse index. Output i of the block reads
+ *        the input offset samples before input i, so each pulse contributes
+ *        the run starting at base - offset, which the mirrored history
+ *        keeps contiguous. Run starts are gathered once per block, then
+ *        each segment is summed 16 outputs at a time with the sums held in
+ *        registers (only the runs are loaded). Every output sums its pulses
+ *        in index order whatever the block size, so results don't depend
+ *        on blocking.
+ *
+ * @param tail output, n samples (added to)
+ * @param base history index of the block's first input
+ * @param n    samples in the block
+ */
+void VelvetReverb::accumulate(float* tail, int base, int n)
+{
+  const float* h = history.data();
+  const uint32_t* o = offsets.data();
+  const float** r = runs.data();
+
+  for (size_t k = 0; k < offsets.size(); ++k)
+  {
+    int start = base - (int)o[k];
+    r[k] = h + (start < 0 ? start + capacity : start);
+  }
+
+  for (const Segment& seg : segments)
+  {
+    int i = 0;
+
+#if defined(VELVET_USE_SSE)
+    const __m128 gain = _mm_set1_ps(seg.gain);
+
+    for (; i + 16 <= n; i += 16)
+    {
+      __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+
+      for (int k = seg.begin; k < seg.split; ++k)
+      {
+        const float* src = r[k] + i;
+        a0 = _mm_add_ps(a0, _mm_loadu_ps(src));
+        a1 = _mm_add_ps(a1, _mm_loadu_ps(src + 4));
+        a2 = _mm_add_ps(a2, _mm_loadu_ps(src + 8));
+        a3 = _mm_add_ps(a3, _mm_loadu_ps(src + 12));
+      }
+
+      for (int k = seg.split; k < seg.end; ++k)
+      {
+        const float* src = r[k] + i;
+        a0 = _mm_sub_ps(a0, _mm_loadu_ps(src));
+        a1 = _mm_sub_ps(a1, _mm_loadu_ps(src + 4));
+        a2 = _mm_sub_ps(a2, _mm_loadu_ps(src + 8));
+        a3 = _mm_sub_ps(a3, _mm_loadu_ps(src + 12));
+      }
+
+      _mm_storeu_ps(tail + i, _mm_add_ps(_mm_loadu_ps(tail + i), _mm_mul_ps(gain, a0)));
+      _mm_storeu_ps(tail + i + 4, _mm_add_ps(_mm_loadu_ps(tail + i + 4), _mm_mul_ps(gain, a1)));
+      _mm_storeu_ps(tail + i + 8, _mm_add_ps(_mm_loadu_ps(tail + i + 8), _mm_mul_ps(gain, a2)));
+      _mm_storeu_ps(tail + i + 12, _mm_add_ps(_mm_loadu_ps(tail + i + 12), _mm_mul_ps(gain, a3)));
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+      float acc = 0.0f;
+
+      for (int k = seg.begin; k < seg.split; ++k)
+        acc += r[k][i];
+
+      for (int k = seg.split; k < seg.end; ++k)
+        acc -= r[k][i];
+
+      tail[i] += seg.gain * acc;
+    }
+  }
+}
+
+/**
+ * @brief Per sample operator, a block of one
+ *
+ * @param x input
+ *
+ * @return float
+ */
+float VelvetReverb::operator()(float x)
+{
+  process(&x, 1);
+
+  return x;
+}
+
+/**
+ * @brief Block operator, processes samples in place
+ *
+ * @param samples    samples to process (in place)
+ * @param numSamples number of samples
+ */
+void VelvetReverb::process(float* samples, int numSamples)
+{
+  run(samples, &samples, 1, numSamples);
+}
+
+/**
+ * @brief Block operator w/ one input and several (identical) outputs
+ *
+ * @param in         input samples (may be one of outs)
+ * @param outs       output buffers
+ * @param numOuts    number of output buffers
+ * @param numSamples number of samples
+ */
+void VelvetReverb::process(const float* in, float* const* outs, int numOuts, int numSamples)
+{
+  run(in, outs, numOuts, numSamples);
+}
+
+void VelvetReverb::process(const double* in, double* const* outs, int numOuts, int numSamples)
+{
+  run(in, outs, numOuts, numSamples);
+}
+
+/**
+ * @brief Block kernel. Each pass writes up to blockSize inputs into both
+ *        halves of the history, gathers the tail for them and mixes it
+ *        with the dry input.
+ *
+ * @param in         input samples (may be one of outs)
+ * @param outs       output buffers
+ * @param numOuts    number of output buffers
+ * @param numSamples number of samples
+ */
+template <class Sample>
+void VelvetReverb::run(const Sample* in, Sample* const* outs, int numOuts, int numSamples)
+{
+  ScopedFlushToZero ftz;
+
+  alignas(16) float tail[blockSize];
+
+  for (int done = 0; done < numSamples; done += blockSize)
+  {
+    const int n = std::min(blockSize, numSamples - done);
+    const Sample* x = in + done;
+
+    std::memset(tail, 0, n * sizeof(float));
+
+    if (capacity)
+    {
+      const int base = writePos;
+
+      for (int i = 0; i < n; ++i)
+      {
+        int w = base + i < capacity ? base + i : base + i - capacity;
+        history[w] = history[w + capacity] = (float)x[i];
+      }
+
+      writePos = base + n < capacity ? base + n : base + n - capacity;
+
+      accumulate(tail, base, n);
+    }
+
+    // dry is read before the first output is written (in may be outs[0])
+    Sample* y = outs[0] + done;
+    for (int i = 0; i < n; ++i)
+      y[i] = (Sample)(dry * x[i] + wet * tail[i]);
+
+    for (int c = 1; c < numOuts; ++c)
+      std::memcpy(outs[c] + done, y, n * sizeof(Sample));
+  }
+}
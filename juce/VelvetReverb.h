@@ -0,0 +1,141 @@
+/**
+ * @file   VelvetReverb.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Velvet noise reverb, a sparse +-1 pulse tail convolved by
+ *         additions only
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include "Filters.h"
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #include <xmmintrin.h>
+  #define VELVET_USE_SSE 1
+#endif
+
+/**
+ * @brief Velvet noise reverb. The tail is one +-1 pulse at a random spot in
+ *        every grid cell of rate / density samples, with the pulses grouped
+ *        into short segments that share one gain (an exponential decay in
+ *        steps). A segment's output is the sum of the input at its positive
+ *        pulses minus the sum at its negative ones, scaled once, so the
+ *        convolution is additions only.
+ *
+ *        Pulse offsets are precomputed into one compact index, and the input
+ *        history is mirrored so every pulse's view of a block is a single
+ *        contiguous run: a block is gathered by adding one run per pulse
+ *        into sums kept in registers (SSE when available).
+ *
+ *        This isn't a cheaper stand-in for the comb bank. Every pulse costs
+ *        an add per output, so the cost grows with tail length and density,
+ *        while MoorerReverb's cost doesn't. Only a short, sparse tail (0.5s
+ *        at 1000 pulses/s) costs about the same as MoorerReverb, a 1s tail
+ *        already costs 2x. Use it for a smooth, uncoloured tail, not to save
+ *        cpu.
+ *
+ *   X                                                      Y
+ *  ---> | history | --> [ segment: +runs -runs ] * g0 --> [SUM] --->
+ *            |      --> [ segment: +runs -runs ] * g1 -->   |
+ *            |                   ...                        |
+ *            ------------------- (dry) * K ---------------->|
+ *
+ */
+class VelvetReverb : public Filter
+{
+public:
+
+  VelvetReverb() = default;
+  VelvetReverb(int samplingRate, double mix_) : rate(samplingRate) { setMix(mix_); generatePulses(); }
+
+  VelvetReverb(const VelvetReverb&) = delete;
+  VelvetReverb& operator=(const VelvetReverb&) = delete;
+
+  void setRate(int sr) { rate = sr; }
+
+  // time to decay by 60dB (seconds)
+  void setDecay(double rt60) { decay = rt60; }
+
+  // pulses per second (a couple of thousand sounds smooth)
+  void setDensity(double pulsesPerSecond) { density = pulsesPerSecond; }
+
+  // tail length (seconds, 0 follows the decay time) and pre delay (ms)
+  void setLength(double seconds) { length = seconds; }
+  void setPredelay(double ms) { predelay = ms; }
+
+  // pulse pattern seed (decorrelated channels use different seeds)
+  void setSeed(uint32_t s) { seed = s; }
+
+  // builds the pulse index for the settings above and sizes the input
+  // history (allocates and clears the tail, don't call from the audio
+  // thread)
+  void generatePulses();
+
+  // zeroes the input history
+  void reset();
+
+  void setMix(double wet_) { wet = wet_; dry = 1.0 - wet_; }
+  double getMix() { return wet; }
+
+  int getNumPulses() const { return (int)offsets.size(); }
+
+  // samples from an impulse to the last pulse
+  int getTailLength() const { return offsets.empty() ? 0 : (int)maxOffset + 1; }
+
+  float operator()(float x) override;
+  void process(float* samples, int numSamples) override;
+
+  // block operators reading in once and writing every output (in may be one
+  // of the outputs), float and double (history and sums stay float)
+  void process(const float* in, float* const* outs, int numOuts, int numSamples);
+  void process(const double* in, double* const* outs, int numOuts, int numSamples);
+
+private:
+
+  // block kernel shared by every process overload
+  template <class Sample>
+  void run(const Sample* in, Sample* const* outs, int numOuts, int numSamples);
+
+  // adds every segment's pulses for the n samples written at base to tail
+  void accumulate(float* tail, int base, int n);
+
+  // pulses sharing one gain, positive ones are [begin, split), negative
+  // ones [split, end) of offsets
+  struct Segment
+  {
+    int begin, split, end;
+    float gain;
+  };
+
+  // samples gathered per pass (the history holds this much beyond the tail)
+  static const int blockSize = 128;
+
+  // length of a constant gain segment
+  static constexpr double segmentSeconds = 0.02;
+
+  int rate = 48000;
+  double decay = 1.5, density = 1500.0, length = 0.0, predelay = 0.0;
+  uint32_t seed = 1;
+
+  // our wet/dry values
+  double wet = 0.2, dry = 0.8;
+
+  // pulse offsets (samples back from the input they're applied to), sorted
+  // within each sign of each segment
+  std::vector<uint32_t> offsets;
+  std::vector<Segment> segments;
+  uint32_t maxOffset = 0;
+
+  // input history, capacity samples stored twice in a row, and where the
+  // next input goes
+  std::vector<float> history;
+  int capacity = 0, writePos = 0;
+
+  // where each pulse's run starts in the current block
+  std::vector<const float*> runs;
+};
@@ -0,0 +1,359 @@
+/**
+ * @file   WorkerPool.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the real-time worker pool
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "WorkerPool.h"
+#include "Denormals.h"
+#include <chrono>
+#include <system_error>
+
+#if defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#elif defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+#endif
+
+// pauses spent on the barrier before polling it with short sleeps (a
+// yielding worker still competes for a shared core), and how long workers
+// go without a block before polls slow to 1ms (audio stopped)
+static const int spinLimit = 4000;
+static const int pollMicroseconds = 50;
+static const int64_t idleNanoseconds = 100000000;
+
+// steady clock in ns
+static int64_t now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// cpu hint that this is a spin wait
+static inline void spinPause()
+{
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  _mm_pause();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief Pins a thread to one core and raises it to real-time priority,
+ *        both best effort (without rtprio rights linux keeps the normal
+ *        priority, other platforms leave the thread as is)
+ *
+ * @param t    thread
+ * @param core core to pin to (< 0 to leave unpinned)
+ */
+static void makeRealtime(std::thread& t, int core)
+{
+#if defined(__linux__)
+  if (core >= 0)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+  }
+
+  sched_param param;
+  param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+  pthread_setschedparam(t.native_handle(), SCHED_FIFO, &param);
+#elif defined(_WIN32)
+  HANDLE h = (HANDLE)t.native_handle();
+
+  if (core >= 0)
+    SetThreadAffinityMask(h, (DWORD_PTR)1 << core);
+
+  SetThreadPriority(h, THREAD_PRIORITY_TIME_CRITICAL);
+#else
+  (void)t;
+  (void)core;
+#endif
+}
+
+/**
+ * @brief Smooths a thread's load toward this block's (rises fast, falls
+ *        slowly, like the plugin's block load)
+ *
+ */
+static void updateLoad(std::atomic<double>& load, double busy, double period)
+{
+  double x = period > 0.0 ? busy / period : 0.0;
+  double l = load.load(std::memory_order_relaxed);
+
+  load.store(l + (x > l ? 0.5 : 0.05) * (x - l), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Starts the worker threads (any running ones are stopped first)
+ *
+ * @param numWorkers threads to start (the caller is one more)
+ * @param firstCore  core the first worker is pinned to (< 0 unpinned)
+ *
+ * @return true if every worker started
+ */
+bool WorkerPool::start(int numWorkers, int firstCore)
+{
+  stop();
+
+  numWorkers = numWorkers < 0 ? 0 : (numWorkers > maxThreads - 1 ? maxThreads - 1 : numWorkers);
+
+  int cores = (int)std::thread::hardware_concurrency();
+  cores = cores < 1 ? 1 : cores;
+
+  for (auto& s : slots)
+  {
+    s.load.store(0.0);
+    s.job.store(0);
+    s.stalls.store(0);
+  }
+
+  overruns.store(0);
+  running.store(true);
+
+  try
+  {
+    for (int t = 1; t <= numWorkers; ++t)
+    {
+      workers.emplace_back(&WorkerPool::workerLoop, this, t);
+      makeRealtime(workers.back(), firstCore < 0 ? -1 : (firstCore + t - 1) % cores);
+    }
+  }
+  catch (const std::system_error&)
+  {
+    stop();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Stops and joins every worker
+ *
+ */
+void WorkerPool::stop()
+{
+  running.store(false);
+
+  for (auto& w : workers)
+    w.join();
+
+  workers.clear();
+}
+
+/**
+ * @brief Worker body, waits on the generation barrier (spinning, then
+ *        polling, more slowly once blocks stop coming) and helps run every
+ *        block it wakes for
+ *
+ * @param thread slot index
+ */
+void WorkerPool::workerLoop(int thread)
+{
+  ScopedFlushToZero ftz;
+
+  uint32_t seen = generation.load();
+  int64_t lastBlock = now();
+
+  for (;;)
+  {
+    uint32_t gen;
+    int spins = 0;
+
+    while ((gen = generation.load(std::memory_order_acquire)) == seen)
+    {
+      if (!running.load(std::memory_order_relaxed))
+        return;
+
+      if (++spins < spinLimit)
+        spinPause();
+      else if (now() - lastBlock < idleNanoseconds)
+        std::this_thread::sleep_for(std::chrono::microseconds(pollMicroseconds));
+      else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    seen = gen;
+    lastBlock = now();
+
+    double busy = claimJobs(thread, gen, blockJob.load(), blockContext.load(), blockCount.load(), blockClaimUntil.load());
+    updateLoad(slots[thread].load, busy, blockPeriod.load());
+  }
+}
+
+/**
+ * @brief Claims jobs one index at a time. The claim only succeeds while the
+ *        index still carries gen, so whatever a thread read about an older
+ *        block can't be acted on. The thread's slot shows the job it's
+ *        inside from start to finish.
+ *
+ * @param thread     slot index
+ * @param gen        block generation
+ * @param job        job to run
+ * @param context    passed to job
+ * @param count      jobs in the block
+ * @param claimUntil stop claiming after this (steady clock ns, 0 never)
+ *
+ * @return double seconds spent running jobs
+ */
+double WorkerPool::claimJobs(int thread, uint32_t gen, Job job, void* context, int count, int64_t claimUntil)
+{
+  std::atomic<uint64_t>& inside = slots[thread].job;
+  int64_t busy = 0;
+
+  for (;;)
+  {
+    uint64_t c = claim.load();
+    int index = (int)(uint32_t)c;
+
+    if ((uint32_t)(c >> 32) != gen || index >= count)
+      break;
+
+    if (claimUntil && now() >= claimUntil)
+      break;
+
+    if (!claim.compare_exchange_weak(c, c + 1))
+      continue;
+
+    inside.store((uint64_t)gen << 32 | (uint32_t)(index + 1), std::memory_order_relaxed);
+
+    int64_t start = now();
+    job(context, index);
+    busy += now() - start;
+
+    inside.store(0, std::memory_order_relaxed);
+
+    done.fetch_add(1, std::memory_order_release);
+  }
+
+  return busy * 1e-9;
+}
+
+/**
+ * @brief Counts a stall for each worker whose slot shows a job of block gen
+ *
+ * @param gen block generation
+ */
+void WorkerPool::markStalls(uint32_t gen)
+{
+  for (int t = 1; t <= getNumWorkers(); ++t)
+  {
+    uint64_t j = slots[t].job.load(std::memory_order_relaxed);
+
+    if ((uint32_t)(j >> 32) == gen && (uint32_t)j != 0)
+      slots[t].stalls.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Runs one block. The claim index moves to the new generation before
+ *        the block is described, then the barrier releases the workers and
+ *        the caller claims with them (past the deadline only the caller
+ *        does). Returns once every claimed job has finished, once the
+ *        period is up the workers still inside a job are counted as
+ *        stalled (the wait goes on, their jobs can't be taken back).
+ *
+ * @param job           job to run
+ * @param context       passed to job
+ * @param count         jobs in the block
+ * @param periodSeconds block length in time
+ *
+ * @return true if the block finished within its period
+ */
+bool WorkerPool::run(Job job, void* context, int count, double periodSeconds)
+{
+  if (count <= 0)
+    return true;
+
+  const int64_t start = now();
+  const uint32_t gen = generation.load() + 1;
+
+  claim.store((uint64_t)gen << 32);
+
+  blockJob.store(job);
+  blockContext.store(context);
+  blockCount.store(count);
+  blockPeriod.store(periodSeconds);
+  blockClaimUntil.store(start + (int64_t)(deadline * periodSeconds * 1e9));
+  done.store(0);
+
+  generation.store(gen, std::memory_order_release);
+
+  ScopedFlushToZero ftz;
+  double busy = claimJobs(0, gen, job, context, count, 0);
+
+  // jobs workers still have in flight, checked against the period every so
+  // often (reading the clock every spin would slow the wait down)
+  const int64_t end = start + (int64_t)(periodSeconds * 1e9);
+  bool late = false;
+  int spins = 0;
+
+  while (done.load(std::memory_order_acquire) < count)
+  {
+    if (++spins < spinLimit)
+      spinPause();
+    else
+      std::this_thread::yield();
+
+    if (!late && (spins & 63) == 0 && now() >= end)
+    {
+      late = true;
+      markStalls(gen);
+    }
+  }
+
+  updateLoad(slots[0].load, busy, periodSeconds);
+
+  if ((now() - start) * 1e-9 > periodSeconds)
+  {
+    overruns.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Gets how many blocks a worker stalled
+ *
+ * @param thread 1 - getNumWorkers()
+ *
+ * @return uint64_t blocks it was still inside a job past the period
+ */
+uint64_t WorkerPool::getStalls(int thread) const
+{
+  if (thread < 1 || thread > getNumWorkers())
+    return 0;
+
+  return slots[thread].stalls.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets a thread's smoothed load
+ *
+ * @param thread 0 for the caller, 1 - getNumWorkers() for workers
+ *
+ * @return double share of the block period (0 - 1, above 1 if overloaded)
+ */
+double WorkerPool::getLoad(int thread) const
+{
+  if (thread < 0 || thread > getNumWorkers())
+    return 0.0;
+
+  return slots[thread].load.load(std::memory_order_relaxed);
+}
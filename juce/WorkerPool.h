@@ -0,0 +1,124 @@
+/**
+ * @file   WorkerPool.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Real-time worker pool, splits each audio block's independent jobs
+ *         (reverb voices) between pinned worker threads and the caller
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool of worker threads woken once per block. The caller publishes
+ *        a block by bumping a generation counter (no locks, no allocation),
+ *        then claims jobs alongside the workers through one atomic index
+ *        (block generation in the top 32 bits, so a late worker can never
+ *        claim into the next block).
+ *
+ *        Workers only claim until the block's deadline, the caller claims
+ *        whatever is left, so a block always completes on the calling
+ *        thread even if every worker misses its wake up.
+ *
+ */
+class WorkerPool
+{
+public:
+
+  // job run once per index of a block
+  using Job = void (*)(void* context, int index);
+
+  // most threads a pool runs (caller included)
+  static const int maxThreads = 64;
+
+  WorkerPool() = default;
+  ~WorkerPool() { stop(); }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // starts numWorkers threads pinned to cores firstCore, firstCore + 1 ...
+  // (wrapping, firstCore < 0 leaves them unpinned) at real-time priority
+  // where the os allows it. Not real-time safe, call before audio starts.
+  bool start(int numWorkers, int firstCore = 1);
+
+  // joins every worker
+  void stop();
+
+  int getNumWorkers() const { return (int)workers.size(); }
+
+  // share of a block (0 - 1) workers may still claim jobs in. This only
+  // bounds claiming: a job a worker already started can't be taken back,
+  // so a worker preempted mid job holds run() up until the os runs it
+  // again (however long that takes). Such stalls are counted per worker
+  // (getStalls), a host seeing them should run fewer workers.
+  void setDeadline(double fraction) { deadline = fraction; }
+
+  // runs job(context, i) for every i < count and returns once all are done.
+  // periodSeconds is the block's length in time (deadline and load are
+  // relative to it). False if the block took longer than its period.
+  bool run(Job job, void* context, int count, double periodSeconds);
+
+  // smoothed share of the block period a thread spent running jobs (0 is
+  // the caller, 1 - getNumWorkers() the workers), any thread may read it
+  double getLoad(int thread) const;
+
+  // blocks that took longer than their period
+  uint64_t getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+
+  // blocks a worker was still inside one of its jobs when the period ran
+  // out (1 - getNumWorkers()), any thread may read it
+  uint64_t getStalls(int thread) const;
+
+private:
+
+  // worker thread body
+  void workerLoop(int thread);
+
+  // claims and runs jobs of block gen on a thread until none are left (or
+  // until claimUntil, in steady clock ns), returns seconds spent running jobs
+  double claimJobs(int thread, uint32_t gen, Job job, void* context, int count, int64_t claimUntil);
+
+  // counts a stall for every worker still inside a job of block gen
+  void markStalls(uint32_t gen);
+
+  // per thread load, the job it's inside (generation << 32 | index + 1,
+  // 0 between jobs) and its stalls, a cache line each so threads never
+  // share one
+  struct alignas(64) Slot
+  {
+    std::atomic<double> load{ 0.0 };
+    std::atomic<uint64_t> job{ 0 };
+    std::atomic<uint64_t> stalls{ 0 };
+  };
+
+  std::vector<std::thread> workers;
+  Slot slots[maxThreads];
+
+  // wake up barrier (bumped once per block) and whether workers keep going
+  alignas(64) std::atomic<uint32_t> generation{ 0 };
+  std::atomic<bool> running{ false };
+
+  // generation << 32 | next job index
+  alignas(64) std::atomic<uint64_t> claim{ 0 };
+
+  // jobs finished in the current block
+  alignas(64) std::atomic<int> done{ 0 };
+
+  // current block, written before generation is bumped
+  std::atomic<Job> blockJob{ nullptr };
+  std::atomic<void*> blockContext{ nullptr };
+  std::atomic<int> blockCount{ 0 };
+  std::atomic<int64_t> blockClaimUntil{ 0 };
+  std::atomic<double> blockPeriod{ 0.0 };
+
+  double deadline = 0.75;
+
+  std::atomic<uint64_t> overruns{ 0 };
+};
@@ -4,7 +4,7 @@
  * @date   2022-03-17
  * @brief  Contains all JUCE editor function declarations
  *
- * @note   This file contains base JUCE code. Modified 2022-06-12.
+ * @note   This file contains base JUCE code. Modified 2026-10-19.
  */
 
 #include "PluginProcessor.h"
@@ -14,7 +14,8 @@
 #define WINDOWY 600
 
 /**
- * @brief Changes processor parameter values if value was changed by user
+ * @brief Records a parameter change made by the user, the latest value per
+ *        parameter is sent on by the next timer frame
  * 
  * @param state reference to processor
  * @param coeff value representing which slider to change
@@ -22,55 +23,71 @@
  * @param value value to change
  */
 void ReverbPlayerAudioProcessorEditor::sliderValueChanged(ReverbPlayerAudioProcessor& state, int coeff, int index, double value)
+{
+  pendingValue[coeff][index] = value;
+  pending[coeff][index] = true;
+
+  // R and g are tied through the ratio, only the latest of the two matters
+  if (coeff == 1)
+    pending[2][index] = false;
+  else if (coeff == 2)
+    pending[1][index] = false;
+}
+
+/**
+ * @brief Sends every parameter changed since the last frame to the processor
+ *        (one event each), updating linked sliders without notifying them so
+ *        they repaint once and don't fire more changes
+ * 
+ */
+void ReverbPlayerAudioProcessorEditor::timerCallback()
 {
   // maintaining ratio between g and R
   // R = ratio - (ratio * g);
   // -> R + (ratio*g) = ratio -> 
   // g = (ratio - R) / ratio;
 
-  switch (coeff)
+  // ratios first, so an R or g change in the same frame uses the new ratio
+  static const int order[numCoeffs] = { 0, 4, 1, 2, 3, 5, 6 };
+
+  for (int coeff : order)
   {
-    // MIX
-    case 0:
-      state.verb.setMix(value/100.0);
-      break;
-
-    // R values
-    case 1:
-      state.verb.lp_combs[index].R = value;
-      g_Vals[index]->setValue((state.verb.lp_combs[index].ratio - state.verb.lp_combs[index].R) / state.verb.lp_combs[index].ratio);
-      break;
-
-    // g values
-    case 2:
-      state.verb.lp_combs[index].g = value;
-      R_Vals[index]->setValue(state.verb.lp_combs[index].ratio - (state.verb.lp_combs[index].ratio * state.verb.lp_combs[index].g));
-      break;
-
-    // L values
-    case 3:
-      state.verb.lp_combs[index].setDelay((value / 1000.0) * state.verb.rate);
-      break;
-
-    // ratio (R/1-g)
-    case 4:
-      state.verb.lp_combs[index].ratio = value;
-      R_Vals[index]->setValue(state.verb.lp_combs[index].ratio - (state.verb.lp_combs[index].ratio * state.verb.lp_combs[index].g));
-      g_Vals[index]->setValue((state.verb.lp_combs[index].ratio - state.verb.lp_combs[index].R) / state.verb.lp_combs[index].ratio);
-      break;
-    
-    // a
-    case 5:
-      state.verb.ap.setCoefficient(value);
-      break;
-
-    // m
-    case 6:
-      state.verb.ap.setDelay((value / 1000.0) * state.verb.rate);
-      break;
-
-    default:
-      break;
+    for (int index = 0; index < 6; ++index)
+    {
+      if (!pending[coeff][index])
+        continue;
+
+      pending[coeff][index] = false;
+
+      const double value = pendingValue[coeff][index];
+      const double ratio = ratios[index]->getValue();
+
+      switch (coeff)
+      {
+        // R values
+        case 1:
+          g_Vals[index]->setValue((ratio - value) / ratio, juce::dontSendNotification);
+          break;
+
+        // g values
+        case 2:
+          R_Vals[index]->setValue(ratio - (ratio * value), juce::dontSendNotification);
+          break;
+
+        // ratio (R/1-g), g is kept
+        case 4:
+          R_Vals[index]->setValue(value - (value * g_Vals[index]->getValue()), juce::dontSendNotification);
+          break;
+
+        default:
+          break;
+      }
+
+      // the processor applies the change on the audio thread at the next block,
+      // a full queue keeps the value for the next frame
+      if (!audioProcessor.pushParameterEvent(coeff, index, value))
+        pending[coeff][index] = true;
+    }
   }
 }
 
@@ -86,12 +103,16 @@ ReverbPlayerAudioProcessorEditor::ReverbPlayerAudioProcessorEditor (ReverbPlayer
   sMix.setSliderStyle(juce::Slider::SliderStyle::LinearVertical);
   sMix.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxAbove, false, WINDOWX / 20, WINDOWY / 30);
   sMix.setNormalisableRange(juce::NormalisableRange<double>(0, 100, 1));
-  sMix.setValue(20);
   sMix.onValueChange = [this] { sliderValueChanged(audioProcessor, 0, 0, sMix.getValue()); };
   
   addAndMakeVisible(bVerb);
   bVerb.setButtonText("Bypass");
-  bVerb.onClick = [this] { audioProcessor.verb.setBypass(); };
+  bVerb.onClick = [this]
+  {
+    // queue full, put the button back so it still shows what's running
+    if (!audioProcessor.toggleBypass())
+      bVerb.setToggleState(!bVerb.getToggleState(), juce::dontSendNotification);
+  };
 
   addAndMakeVisible(a);
   addAndMakeVisible(m);
@@ -99,8 +120,6 @@ ReverbPlayerAudioProcessorEditor::ReverbPlayerAudioProcessorEditor (ReverbPlayer
   m.setSliderStyle(juce::Slider::SliderStyle::LinearBar);
   a.setNormalisableRange(juce::NormalisableRange<double>(0.0, 1.0, 0.01));
   m.setNormalisableRange(juce::NormalisableRange<double>(0.0, 100.0, 1.0));
-  a.setValue(0.7);
-  m.setValue(6);
   a.onValueChange = [this] { sliderValueChanged(audioProcessor, 5, 0, a.getValue()); };
   m.onValueChange = [this] { sliderValueChanged(audioProcessor, 6, 0, m.getValue()); };
 
@@ -131,17 +150,17 @@ ReverbPlayerAudioProcessorEditor::ReverbPlayerAudioProcessorEditor (ReverbPlayer
     L_Vals[i]->setNormalisableRange(juce::NormalisableRange<double>(0, 100, 1));
     ratios[i]->setNormalisableRange(juce::NormalisableRange<double>(0.01, 1.0, 0.01));
 
-    g_Vals[i]->setValue(audioProcessor.verb.lp_combs[i].g);
-    R_Vals[i]->setValue(audioProcessor.verb.lp_combs[i].R);
-    L_Vals[i]->setValue(audioProcessor.verb.lp_combs[i].L / 48);
-    ratios[i]->setValue(0.83);
-
     R_Vals[i]->onValueChange = [this, i] { sliderValueChanged(audioProcessor, 1, i, R_Vals[i]->getValue()); };
     g_Vals[i]->onValueChange = [this, i] { sliderValueChanged(audioProcessor, 2, i, g_Vals[i]->getValue()); };
     L_Vals[i]->onValueChange = [this, i] { sliderValueChanged(audioProcessor, 3, i, L_Vals[i]->getValue()); };
     ratios[i]->onValueChange = [this, i] { sliderValueChanged(audioProcessor, 4, i, ratios[i]->getValue()); };
   }
 
+  refreshSliders();
+  audioProcessor.addChangeListener(this);
+
+  startTimerHz(frameRate);
+
   addAndMakeVisible(audioProcessor.getViz1());
   addAndMakeVisible(audioProcessor.getViz2());
 
@@ -154,6 +173,45 @@ ReverbPlayerAudioProcessorEditor::ReverbPlayerAudioProcessorEditor (ReverbPlayer
  */
 ReverbPlayerAudioProcessorEditor::~ReverbPlayerAudioProcessorEditor()
 {
+  stopTimer();
+  audioProcessor.removeChangeListener(this);
+}
+
+/**
+ * @brief Reloads every slider from the processor's parameters, without
+ *        notifying (the processor already has these values)
+ * 
+ */
+void ReverbPlayerAudioProcessorEditor::refreshSliders()
+{
+  const MoorerParameters p = audioProcessor.getParameters();
+
+  sMix.setValue(p.mix * 100.0, juce::dontSendNotification);
+  a.setValue(p.a, juce::dontSendNotification);
+  m.setValue(p.m, juce::dontSendNotification);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    g_Vals[i]->setValue(p.g[i], juce::dontSendNotification);
+    R_Vals[i]->setValue(p.ratio[i] - (p.ratio[i] * p.g[i]), juce::dontSendNotification);
+    L_Vals[i]->setValue(p.L[i], juce::dontSendNotification);
+    ratios[i]->setValue(p.ratio[i], juce::dontSendNotification);
+  }
+}
+
+/**
+ * @brief Processor switched program or loaded state, show the new values
+ * 
+ * @param source processor that changed
+ */
+void ReverbPlayerAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+  // edits not sent yet were made against the old values
+  for (int coeff = 0; coeff < numCoeffs; ++coeff)
+    for (int index = 0; index < 6; ++index)
+      pending[coeff][index] = false;
+
+  refreshSliders();
 }
 
 /**
@@ -4,7 +4,7 @@
  * @date   2022-03-17
  * @brief  Contains JUCE editor class and everything pertaining to it
  *
- * @note   This file contains base JUCE code. Modified 2022-06-12.
+ * @note   This file contains base JUCE code. Modified 2026-10-19.
  */
 
 #pragma once
@@ -16,7 +16,9 @@
  * @brief Editor class
  * 
  */
-class ReverbPlayerAudioProcessorEditor  : public juce::AudioProcessorEditor
+class ReverbPlayerAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                          private juce::ChangeListener,
+                                          private juce::Timer
 {
 public:
   ReverbPlayerAudioProcessorEditor (ReverbPlayerAudioProcessor&);
@@ -27,10 +29,29 @@ public:
     
   // ui -> parameter communication
   // coeff is param; mix, R, g, L values are 0,1,...
+  // (only records the change, the timer sends it on at most once a frame)
   void sliderValueChanged(ReverbPlayerAudioProcessor& state, int coeff, int index, double value);
 
 private:
 
+  // reloads every slider from the processor's parameters (no notifications)
+  void refreshSliders();
+
+  // processor replaced its parameters (program change / state load)
+  void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+  // once a frame, updates linked sliders and pushes every changed parameter
+  void timerCallback() override;
+
+  // ui frame rate changes are coalesced to
+  static const int frameRate = 30;
+
+  // latest value of every parameter changed since the last frame, indexed
+  // by coeff (mix, R, g, L, ratio, a, m) and comb
+  static const int numCoeffs = 7;
+  double pendingValue[numCoeffs][6] = { };
+  bool pending[numCoeffs][6] = { };
+
   // all our sliders and buttons
   juce::Slider sMix { "Mix" };
 
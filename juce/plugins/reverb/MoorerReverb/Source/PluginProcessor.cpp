@@ -4,12 +4,110 @@
  * @date   2022-03-17
  * @brief  
  *
- * @note   This file contains base JUCE code. Modified 2022-06-12.
+ * @note   This file contains base JUCE code. Modified 2026-10-19.
  */
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+/**
+ * @brief Factory preset, name + every parameter
+ * 
+ */
+struct Preset
+{
+  const char* name;
+  MoorerParameters params;
+};
+
+// mix, g, ratio, L (ms), a, m (ms), diffuser stages, nested
+static const Preset presets[] =
+{
+  { "Moorer Default", { 0.2,  { 0.44, 0.46, 0.48, 0.50, 0.51, 0.53 }, { 0.83, 0.83, 0.83, 0.83, 0.83, 0.83 },
+                        { 50.0, 56.0, 61.0, 68.0, 72.0, 78.0 }, 0.7, 6.0, 4, false } },
+  { "Small Room",     { 0.15, { 0.30, 0.32, 0.33, 0.35, 0.36, 0.38 }, { 0.70, 0.70, 0.70, 0.70, 0.70, 0.70 },
+                        { 23.0, 27.0, 31.0, 34.0, 37.0, 41.0 }, 0.6, 3.0, 3, false } },
+  { "Large Hall",     { 0.3,  { 0.46, 0.48, 0.50, 0.52, 0.53, 0.55 }, { 0.90, 0.90, 0.90, 0.90, 0.90, 0.90 },
+                        { 62.0, 70.0, 76.0, 85.0, 90.0, 97.0 }, 0.7, 8.0, 4, true } },
+  { "Dense Plate",    { 0.25, { 0.22, 0.24, 0.25, 0.27, 0.28, 0.30 }, { 0.88, 0.88, 0.88, 0.88, 0.88, 0.88 },
+                        { 29.0, 33.0, 37.0, 41.0, 43.0, 47.0 }, 0.75, 5.0, 6, true } },
+};
+
+static const int numPresets = (int)(sizeof(presets) / sizeof(presets[0]));
+
+// binary state header ("MRVB") and version
+static const int stateMagic = 0x4d525642;
+static const int stateVersion = 1;
+
+// header (3 ints), mix + 18 comb values + a/m (doubles), stages (int), nested (bool)
+static const int stateSize = 3 * 4 + 21 * 8 + 4 + 1;
+
+// how long a program change crossfades the dry level for (seconds), wet
+// tails aren't faded: the outgoing one rings out on silence
+static const double fadeSeconds = 0.005;
+
+// level the outgoing tail has to stay under for spillQuietSeconds (a full
+// trip around the longest comb) before its spill ends, longest a spill runs,
+// and how long a spill that's cut short fades out for
+static const double spillSilence = 1.0e-5;
+static const double spillQuietSeconds = MoorerReverb::maxDelaySeconds;
+static const double spillMaxSeconds = 30.0;
+static const double releaseSeconds = 0.05;
+
+// how often the message thread syncs parameters and retries a queued switch
+static const int syncHz = 30;
+
+// host automation only comes once per block, gain changes are ramped across
+// the block in up to rampSteps steps at least rampSpacing samples apart
+static const int rampSteps = 8;
+static const int rampSpacing = 32;
+
+// combs and diffuser stages run at each quality level (stages are capped by
+// the diffuser's own stage count)
+static const int qualityCombs[ReverbPlayerAudioProcessor::numQualityLevels] = { 6, 4, 4, 3 };
+static const int qualityStages[ReverbPlayerAudioProcessor::numQualityLevels] = { 8, 8, 2, 1 };
+
+// block time / deadline above which quality steps down, and below which it
+// may step back up once it has stayed there for qualityHoldSeconds
+static const double loadHigh = 0.7;
+static const double loadLow = 0.35;
+static const double qualityHoldSeconds = 1.0;
+
+// shortest time between two steps down (lets the previous fade finish)
+static const double qualityDwellSeconds = 0.05;
+
+/**
+ * @brief Applies a parameter event to a parameter set, the same way
+ *        applyParameterEvent does to a reverb (R and g are tied through the
+ *        comb's ratio, bypass isn't a parameter)
+ * 
+ * @param p parameters to change
+ * @param e event to apply
+ */
+static void applyToParameters(MoorerParameters& p, const ParameterEvent& e)
+{
+  switch (e.coeff)
+  {
+    case 0: p.mix = e.value / 100.0; break;
+    case 1: p.g[e.index] = (p.ratio[e.index] - e.value) / p.ratio[e.index]; break;
+    case 2: p.g[e.index] = e.value; break;
+    case 3: p.L[e.index] = e.value; break;
+    case 4: p.ratio[e.index] = e.value; break;
+    case 5: p.a = e.value; break;
+    case 6: p.m = e.value; break;
+    default: break;
+  }
+}
+
+/**
+ * @brief Level a reverb passes its input through at
+ * 
+ */
+static double dryLevel(MoorerReverb& verb)
+{
+  return verb.isBypassed() ? 1.0 : 1.0 - verb.getMix();
+}
+
 /**
  * @brief Constructor + initializes parameters
  * 
@@ -30,12 +128,21 @@ ReverbPlayerAudioProcessor::ReverbPlayerAudioProcessor()
   pState = new juce::AudioProcessorValueTreeState(*this, nullptr);
 
   // some default initialization (values proposed by moorer)
-  verb.setRate(48000);
-  verb.setMix(0.2);
-  verb.initializeFilters();
+  params = presets[0].params;
+  live = { params, 0, 0 };
+
+  for (auto& slot : liveSlots)
+    slot = live;
+
+  for (auto& verb : verbs)
+  {
+    verb.setRate(48000);
+    verb.initializeFilters();
+    verb.applyParameters(params);
+  }
   
   // add all our parameters to value tree
-  pState->createAndAddParameter("mix", "Mix", "Mix", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), verb.getMix(), nullptr, nullptr);
+  pState->createAndAddParameter("mix", "Mix", "Mix", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), params.mix, nullptr, nullptr);
 
   for (int i = 0; i < 6; ++i)
   {
@@ -46,9 +153,9 @@ ReverbPlayerAudioProcessor::ReverbPlayerAudioProcessor()
     std::string s5 = std::string("l" + std::to_string(i));
     std::string s6 = std::string("L" + std::to_string(i));
 
-    pState->createAndAddParameter(s1, s2, s2, juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), verb.lp_combs[i].g, nullptr, nullptr);
-    pState->createAndAddParameter(s3, s4, s4, juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), verb.lp_combs[i].R, nullptr, nullptr);
-    pState->createAndAddParameter(s5, s6, s6, juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f), verb.lp_combs[i].L / 48 , nullptr, nullptr);
+    pState->createAndAddParameter(s1, s2, s2, juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), params.g[i], nullptr, nullptr);
+    pState->createAndAddParameter(s3, s4, s4, juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), params.ratio[i] - (params.ratio[i] * params.g[i]), nullptr, nullptr);
+    pState->createAndAddParameter(s5, s6, s6, juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f), params.L[i], nullptr, nullptr);
   }
 
   pState->state = juce::ValueTree("mix");
@@ -66,6 +173,21 @@ ReverbPlayerAudioProcessor::ReverbPlayerAudioProcessor()
     pState->state = juce::ValueTree(juce::Identifier(s3));
     pState->state = juce::ValueTree(juce::Identifier(s5));
   }
+
+  // keep raw host values around so automation can be checked every block
+  attachHostParameter(hostMix, "mix");
+
+  for (int i = 0; i < 6; ++i)
+  {
+    attachHostParameter(hostG[i], juce::String("g") + juce::String(i));
+    attachHostParameter(hostR[i], juce::String("r") + juce::String(i));
+    attachHostParameter(hostL[i], juce::String("l") + juce::String(i));
+  }
+
+  // room for a full ui queue, host changes and plenty of MIDI CCs
+  blockEvents.reserve(uiFifoSize + 1024);
+
+  startTimerHz(syncHz);
 }
 
 /**
@@ -135,6 +257,45 @@ void ReverbPlayerAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
 {
   Viz1.setNumChannels(1);
   Viz2.setNumChannels(1);
+
+  // audio isn't running, so a switch that was handed over takes effect now
+  // and a spilling tail ends
+  if (switchState.load(std::memory_order_acquire) == Ready)
+    startSwitch();
+
+  switchState.store(Idle);
+
+  // both reverbs are brought up to the new rate here, the only place delay
+  // memory is allocated. A re-confirmed rate leaves the filters (and their
+  // tails) alone. Parameters are the ones the audio thread was running, so
+  // host automation and MIDI changes are kept.
+  for (auto& verb : verbs)
+  {
+    if (verb.rate != (int)sampleRate)
+    {
+      verb.setRate((int)sampleRate);
+      verb.initializeFilters();
+    }
+
+    verb.applyParameters(live.params);
+  }
+
+  currentRate = sampleRate;
+  blockLoad = 0.0;
+  samplesSinceStep = 0;
+  samplesUnderLoad = 0;
+
+  for (auto& verb : verbs)
+    applyQualityLevel(verb);
+
+  fadeLength = juce::jmax(1, (int)(fadeSeconds * sampleRate));
+  releaseLength = juce::jmax(1, (int)(releaseSeconds * sampleRate));
+  spillBuffer.assign(juce::jmax(1, samplesPerBlock), 0.0f);
+  spillBufferDouble.assign(juce::jmax(1, samplesPerBlock), 0.0);
+  vizBuffer.assign(juce::jmax(1, samplesPerBlock), 0.0f);
+
+  if (liveChanged)
+    publishLive();
 }
 
 /**
@@ -173,43 +334,695 @@ juce::AudioProcessorValueTreeState& ReverbPlayerAudioProcessor::getState()
   return *pState;
 }
 
+/**
+ * @brief Queues a parameter change from the ui. If the queue is full nothing
+ *        changes (not even the message thread copy) and false is returned,
+ *        the caller keeps the value and tries again.
+ * 
+ * @param coeff value representing which parameter to change
+ * @param index index of which indexed value to change (if applicable)
+ * @param value value to change
+ * 
+ * @return true if the change was queued
+ */
+bool ReverbPlayerAudioProcessor::pushParameterEvent(int coeff, int index, double value)
+{
+  const auto scope = uiFifo.write(1);
+
+  if (scope.blockSize1 == 0)
+    return false;
+
+  const ParameterEvent e { 0, coeff, index, value };
+  uiEvents[scope.startIndex1] = e;
+
+  // keep message thread copy in line, the event is replayed over the audio
+  // thread's parameters until they include it
+  uiSent[uiPushed++ % uiFifoSize] = e;
+  applyToParameters(params, e);
+
+  return true;
+}
+
+/**
+ * @brief Binds a host parameter
+ * 
+ * @param h  host parameter
+ * @param id parameter id
+ */
+void ReverbPlayerAudioProcessor::attachHostParameter(HostParameter& h, const juce::String& id)
+{
+  h.raw = pState->getRawParameterValue(id);
+  h.param = pState->getParameter(id);
+  h.last = h.raw->load();
+}
+
+/**
+ * @brief Queues events if a host parameter changed, a ramp of steps events
+ *        spread evenly over the block from the last value to the new one
+ *        (a single step lands on the first sample). A change the message
+ *        thread made (writing live values back) is taken once without an
+ *        event, one it's still making is looked at again next block.
+ * 
+ * @param h          host parameter
+ * @param coeff      parameter number
+ * @param index      comb index (if applicable)
+ * @param scale      host value -> editor value scale
+ * @param numSamples # of samples in block
+ * @param steps      events to ramp over
+ */
+void ReverbPlayerAudioProcessor::checkHostParameter(HostParameter& h, int coeff, int index, double scale,
+                                                    int numSamples, int steps)
+{
+  float v = h.raw->load();
+  float echo = h.echo.load();
+
+  if (v == h.last || echo == echoBusy)
+    return;
+
+  if (v == echo)
+  {
+    if (h.echo.compare_exchange_strong(echo, echoNone))
+      h.last = v;
+
+    return;
+  }
+
+  const int room = (int)(blockEvents.capacity() - blockEvents.size());
+
+  if (room > 0)
+  {
+    // automation came after whatever was written back
+    h.echo.compare_exchange_strong(echo, echoNone);
+
+    steps = juce::jmin(steps, room);
+
+    for (int k = 1; k <= steps; ++k)
+    {
+      double value = k == steps ? v : h.last + (v - h.last) * (double)k / steps;
+      blockEvents.push_back({ (k - 1) * numSamples / steps, coeff, index, value * scale });
+    }
+
+    h.last = v;
+  }
+}
+
+/**
+ * @brief Writes a value to a host parameter unless it already shows it to the
+ *        parameter's resolution (so a value between steps isn't written back
+ *        every frame). The echo is marked busy around the write, then holds
+ *        the value the parameter ended up with.
+ * 
+ * @param h     host parameter
+ * @param value value to show
+ */
+void ReverbPlayerAudioProcessor::pushHostParameter(HostParameter& h, double value)
+{
+  const auto& range = h.param->getNormalisableRange();
+
+  if (std::abs(h.raw->load() - value) <= 0.5 * range.interval + 1.0e-6)
+    return;
+
+  h.echo.store(echoBusy);
+  h.param->setValueNotifyingHost(range.convertTo0to1((float)value));
+  h.echo.store(h.raw->load());
+}
+
+/**
+ * @brief Gathers every parameter change for the block, ordered by sample
+ *        offset (events on the same sample keep the order they came in).
+ *        ui changes land on the first sample and MIDI CCs keep their
+ *        timestamps. Host automation is only block accurate, JUCE gives no
+ *        timestamps for it: mix, R and g ramp from their last value across
+ *        the block, L steps on the first sample (a ramped delay would jump
+ *        several times).
+ * 
+ * @param midiMessages MIDI for this block
+ * @param numSamples   # of samples in block
+ */
+void ReverbPlayerAudioProcessor::collectParameterEvents(juce::MidiBuffer& midiMessages, int numSamples)
+{
+  blockEvents.clear();
+
+  // ui changes
+  {
+    const auto scope = uiFifo.read(uiFifo.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+      blockEvents.push_back(uiEvents[scope.startIndex1 + i]);
+    for (int i = 0; i < scope.blockSize2; ++i)
+      blockEvents.push_back(uiEvents[scope.startIndex2 + i]);
+
+    live.uiApplied += (juce::uint32)(scope.blockSize1 + scope.blockSize2);
+  }
+
+  // host automation (mix is 0-1 on the host, percent in the editor)
+  const int steps = juce::jlimit(1, rampSteps, numSamples / rampSpacing);
+
+  checkHostParameter(hostMix, 0, 0, 100.0, numSamples, steps);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    checkHostParameter(hostR[i], 1, i, 1.0, numSamples, steps);
+    checkHostParameter(hostG[i], 2, i, 1.0, numSamples, steps);
+    checkHostParameter(hostL[i], 3, i, 1.0, numSamples, 1);
+  }
+
+  // MIDI CC, already in time order
+  for (const auto metadata : midiMessages)
+  {
+    const auto msg = metadata.getMessage();
+
+    if (!msg.isController() || blockEvents.size() == blockEvents.capacity())
+      continue;
+
+    int cc = msg.getControllerNumber();
+    double v = msg.getControllerValue() / 127.0;
+    int offset = juce::jlimit(0, numSamples - 1, metadata.samplePosition);
+
+    if (cc == ccMix)
+      blockEvents.push_back({ offset, 0, 0, v * 100.0 });
+    else if (cc >= ccFirstG && cc < ccFirstG + 6)
+      blockEvents.push_back({ offset, 2, cc - ccFirstG, v });
+    else if (cc >= ccFirstR && cc < ccFirstR + 6)
+      blockEvents.push_back({ offset, 1, cc - ccFirstR, v });
+    else if (cc >= ccFirstL && cc < ccFirstL + 6)
+      blockEvents.push_back({ offset, 3, cc - ccFirstL, v * 100.0 });
+  }
+
+  // ramps interleave with the CCs, insertion sort keeps equal offsets in
+  // order and doesn't allocate
+  for (size_t i = 1; i < blockEvents.size(); ++i)
+  {
+    ParameterEvent e = blockEvents[i];
+    size_t j = i;
+
+    for (; j > 0 && blockEvents[j - 1].sampleOffset > e.sampleOffset; --j)
+      blockEvents[j] = blockEvents[j - 1];
+
+    blockEvents[j] = e;
+  }
+
+  // live parameters as they'll stand once the block's events are applied
+  for (const auto& e : blockEvents)
+    applyToParameters(live.params, e);
+
+  liveChanged = liveChanged || !blockEvents.empty();
+}
+
+/**
+ * @brief Applies a parameter change to a reverb, keeping R/g in line with
+ *        the comb's ratio (R = ratio - (ratio * g))
+ * 
+ * @param verb reverb to change
+ * @param e    event to apply
+ */
+void ReverbPlayerAudioProcessor::applyParameterEvent(MoorerReverb& verb, const ParameterEvent& e)
+{
+  switch (e.coeff)
+  {
+    // MIX
+    case 0:
+      verb.setMix(e.value / 100.0);
+      break;
+
+    // R values
+    case 1:
+    {
+      LowPassComb& c = verb.lp_combs[e.index];
+      c.R = e.value;
+      c.g = (c.ratio - c.R) / c.ratio;
+      break;
+    }
+
+    // g values
+    case 2:
+    {
+      LowPassComb& c = verb.lp_combs[e.index];
+      c.g = e.value;
+      c.R = c.ratio - (c.ratio * c.g);
+      break;
+    }
+
+    // L values (rounded like applyParameters, so reapplying lands on the same delay)
+    case 3:
+      verb.lp_combs[e.index].setDelay((int)std::round(e.value * 0.001 * verb.rate));
+      break;
+
+    // ratio (R/1-g)
+    case 4:
+    {
+      LowPassComb& c = verb.lp_combs[e.index];
+      c.ratio = e.value;
+      c.R = c.ratio - (c.ratio * c.g);
+      break;
+    }
+
+    // a
+    case 5:
+      verb.diffuser.setCoefficient(e.value);
+      break;
+
+    // m
+    case 6:
+      verb.diffuser.setDelay((int)std::round(e.value * 0.001 * verb.rate));
+      break;
+
+    // bypass
+    case 7:
+      verb.setBypass();
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Runs a span through the active reverb, which reads the input once
+ *        and writes every output. While a program change is spilling, the
+ *        outgoing reverb keeps running on silence and its tail is added to
+ *        the output, so nothing that was ringing is cut. Only the dry level
+ *        crossfades (it would step otherwise). The spill ends once the dry
+ *        fade is done and the tail has been quiet for a trip around the
+ *        longest comb, or fades out if it runs too long or another switch
+ *        needs the reverb.
+ * 
+ * @param in         input channel (may be outs[0])
+ * @param outs       output channels
+ * @param numOuts    number of outputs
+ * @param offset     first sample of the span
+ * @param numSamples number of samples
+ */
+template <class Sample>
+void ReverbPlayerAudioProcessor::processSpan(const Sample* in, Sample* const* outs, int numOuts, int offset, int numSamples)
+{
+  MoorerReverb& verb = verbs[active.load()];
+  Sample* spanOuts[2];
+
+  for (int o = 0; o < numOuts; ++o)
+    spanOuts[o] = outs[o] + offset;
+
+  if (switchState.load() != Spilling)
+  {
+    verb.process(in + offset, spanOuts, numOuts, numSamples);
+    return;
+  }
+
+  MoorerReverb& tail = verbs[1 - active.load()];
+  Sample* y = getSpillBuffer((Sample*)nullptr);
+  const int chunk = (int)spillBuffer.size();
+  const double dry = dryLevel(verb);
+
+  if (!releasing && (releaseSpill.load() || spillPos >= (juce::int64)(spillMaxSeconds * currentRate)))
+  {
+    releasing = true;
+    releasePos = 0;
+  }
+
+  for (int start = 0; start < numSamples; start += chunk)
+  {
+    int n = juce::jmin(chunk, numSamples - start);
+    const Sample* x = in + offset + start;
+    Sample* out = spanOuts[0] + start;
+
+    // outgoing tail on silence
+    std::fill(y, y + n, (Sample)0);
+    tail.process(y, &y, 1, n);
+
+    for (int i = 0; i < n; ++i)
+    {
+      spillQuiet = std::abs(y[i]) > spillSilence ? 0 : spillQuiet + 1;
+
+      if (releasing)
+        y[i] *= (Sample)juce::jmax(0.0, 1.0 - (double)releasePos++ / releaseLength);
+
+      // what's left of the outgoing dry level (read before the incoming
+      // reverb overwrites the input)
+      double t = juce::jmin(1.0, (double)(fadePos + i) / fadeLength);
+      y[i] += (Sample)((1.0 - t) * (fadeDry - dry) * x[i]);
+    }
+
+    verb.process(x, &out, 1, n);
+
+    for (int i = 0; i < n; ++i)
+      out[i] += y[i];
+
+    for (int o = 1; o < numOuts; ++o)
+      std::memcpy(spanOuts[o] + start, out, n * sizeof(Sample));
+
+    fadePos = juce::jmin(fadePos + n, fadeLength);
+    spillPos += n;
+  }
+
+  // tail has rung out (or been faded out), the outgoing reverb is free again
+  bool quiet = spillQuiet >= (int)(spillQuietSeconds * currentRate);
+
+  if (fadePos >= fadeLength && (quiet || (releasing && releasePos >= releaseLength)))
+    switchState.store(Idle, std::memory_order_release);
+}
+
+/**
+ * @brief Prepares the standby reverb with new parameters (message thread)
+ *        and hands it to the audio thread to switch to. It starts from
+ *        silence, the outgoing reverb's tail carries on next to it. Delay
+ *        memory is reused, so nothing is allocated.
+ * 
+ * @param p parameters to switch to
+ * 
+ * @return true if the switch was started
+ */
+bool ReverbPlayerAudioProcessor::prepareSwitch(const MoorerParameters& p)
+{
+  int expected = Idle;
+
+  if (!switchState.compare_exchange_strong(expected, Preparing, std::memory_order_acquire))
+    return false;
+
+  MoorerReverb& next = verbs[1 - active.load()];
+  next.applyParameters(p);
+  next.reset();
+
+  switchParams = p;
+  params = p;
+  ++switchesRequested;
+  releaseSpill.store(false);
+
+  switchState.store(Ready, std::memory_order_release);
+
+  // let the host and the editor catch up with the new values
+  syncParameters();
+  sendChangeMessage();
+
+  return true;
+}
+
+/**
+ * @brief Switches to new parameters, queueing them if a switch is still
+ *        spilling (the latest request wins, and the spill is cut short)
+ * 
+ * @param p parameters to switch to
+ */
+void ReverbPlayerAudioProcessor::requestParameters(const MoorerParameters& p)
+{
+  if (prepareSwitch(p))
+    return;
+
+  pendingParams = p;
+  hasPending = true;
+
+  if (switchState.load() == Spilling)
+    releaseSpill.store(true);
+}
+
+/**
+ * @brief Makes the prepared reverb active (matching bypass and quality), and
+ *        starts the outgoing one's spill
+ * 
+ */
+void ReverbPlayerAudioProcessor::startSwitch()
+{
+  MoorerReverb& from = verbs[active.load()];
+  MoorerReverb& next = verbs[1 - active.load()];
+
+  if (next.isBypassed() != from.isBypassed())
+    next.setBypass();
+
+  applyQualityLevel(next);
+
+  fadeDry = dryLevel(from);
+  fadePos = 0;
+  spillPos = 0;
+  spillQuiet = 0;
+  releasing = false;
+
+  active.store(1 - active.load());
+
+  live.params = switchParams;
+  ++live.switchesApplied;
+  liveChanged = true;
+
+  switchState.store(Spilling);
+}
+
+/**
+ * @brief Retries a queued switch (cutting a spill short while it waits),
+ *        then syncs parameters
+ * 
+ */
+void ReverbPlayerAudioProcessor::timerCallback()
+{
+  if (hasPending)
+  {
+    if (prepareSwitch(pendingParams))
+      hasPending = false;
+    else if (switchState.load() == Spilling)
+      releaseSpill.store(true);
+  }
+
+  syncParameters();
+}
+
+/**
+ * @brief Takes the newest parameters the audio thread published and replays
+ *        the ui events it hadn't picked up yet over them, so the copy holds
+ *        everything the audio thread runs (host automation and MIDI
+ *        included) plus what's on its way. A copy from before the latest
+ *        switch is skipped, params already holds that switch. The result is
+ *        written to the host parameters.
+ * 
+ */
+void ReverbPlayerAudioProcessor::syncParameters()
+{
+  if (liveLatest.load(std::memory_order_acquire) & liveFresh)
+  {
+    liveFront = liveLatest.exchange(liveFront, std::memory_order_acq_rel) & 3;
+    const LiveParameters& s = liveSlots[liveFront];
+
+    if (s.switchesApplied == switchesRequested)
+    {
+      MoorerParameters p = s.params;
+
+      for (juce::uint32 n = s.uiApplied; n != uiPushed; ++n)
+        applyToParameters(p, uiSent[n % uiFifoSize]);
+
+      params = p;
+    }
+  }
+
+  pushHostParameter(hostMix, params.mix);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    pushHostParameter(hostG[i], params.g[i]);
+    pushHostParameter(hostR[i], params.ratio[i] - (params.ratio[i] * params.g[i]));
+    pushHostParameter(hostL[i], params.L[i]);
+  }
+}
+
+/**
+ * @brief Publishes the live parameters into the back slot and swaps it with
+ *        the newest one (wait free, nothing is allocated)
+ * 
+ */
+void ReverbPlayerAudioProcessor::publishLive()
+{
+  liveSlots[liveBack] = live;
+  liveBack = liveLatest.exchange(liveBack | liveFresh, std::memory_order_acq_rel) & 3;
+  liveChanged = false;
+}
+
 /**
  * @brief Processes audio input using Moorer Reverb class
  * 
  */
 void ReverbPlayerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+  processSamples(buffer, midiMessages);
+}
+
+/**
+ * @brief Double precision version, the reverb runs in double end to end
+ * 
+ */
+void ReverbPlayerAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+  processSamples(buffer, midiMessages);
+}
+
+/**
+ * @brief Shared block body. The block is split at every parameter event so
+ *        changes land on the exact sample, while each span in between still
+ *        runs through the block kernel. The left input is read once and the
+ *        reverb writes both outputs in the same pass.
+ * 
+ */
+template <class Sample>
+void ReverbPlayerAudioProcessor::processSamples(juce::AudioBuffer<Sample>& buffer, juce::MidiBuffer& midiMessages)
 {
   juce::ScopedNoDenormals noDenormals;
-  auto totalNumInputChannels  = getTotalNumInputChannels();
-  auto totalNumOutputChannels = getTotalNumOutputChannels();
-  
-  // stereo
-  buffer.copyFrom(1, 0, buffer, 0, 0, buffer.getNumSamples());
+  const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+  const int numSamples = buffer.getNumSamples();
+
+  // mono in, stereo out
+  Sample* outs[2] = { buffer.getWritePointer(0), nullptr };
+  const int numOuts = juce::jmin(2, buffer.getNumChannels());
 
-  // push buffer to visualizer before affected
-  Viz1.pushBuffer(buffer);
+  if (numOuts > 1)
+    outs[1] = buffer.getWritePointer(1);
+
+  const Sample* in = outs[0];
+
+  // push input to visualizer before affected
+  pushVisualizer(Viz1, in, numSamples);
 
   // ********************* //
-    
-  float* l = buffer.getWritePointer(0);
-  float* r = buffer.getWritePointer(1);
- 
-  // for each sample
-  for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+
+  // a prepared program change takes over with this block, the block's
+  // events land on it
+  if (switchState.load(std::memory_order_acquire) == Ready)
+    startSwitch();
+
+  collectParameterEvents(midiMessages, numSamples);
+
+  int pos = 0;
+
+  for (const auto& e : blockEvents)
   {
-    // store clean data
-    float clean = *l;
-        
-    /** Reverb calculations  **/
-    *l = verb(*l);
-    *r = *l;
-
-    l++; r++;
+    // run everything up to the event, then apply it
+    if (e.sampleOffset > pos)
+    {
+      processSpan(in, outs, numOuts, pos, e.sampleOffset - pos);
+      pos = e.sampleOffset;
+    }
+
+    applyParameterEvent(verbs[active.load()], e);
   }
 
-  
-  // push buffer to visualizer after affected
-  Viz2.pushBuffer(buffer);
+  processSpan(in, outs, numOuts, pos, numSamples - pos);
+
+  if (liveChanged)
+    publishLive();
+
+  // push output to visualizer after affected
+  pushVisualizer(Viz2, outs[0], numSamples);
+
+  updateQuality(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks), numSamples);
+}
+
+/**
+ * @brief Pushes a channel to a visualizer
+ * 
+ * @param viz        visualizer
+ * @param samples    channel samples
+ * @param numSamples number of samples
+ */
+void ReverbPlayerAudioProcessor::pushVisualizer(Visualizer& viz, const float* samples, int numSamples)
+{
+  viz.pushBuffer(&samples, 1, numSamples);
+}
+
+/**
+ * @brief Pushes a double channel to a visualizer, converted in chunks through
+ *        a float scratch buffer (display only, the audio stays double)
+ * 
+ * @param viz        visualizer
+ * @param samples    channel samples
+ * @param numSamples number of samples
+ */
+void ReverbPlayerAudioProcessor::pushVisualizer(Visualizer& viz, const double* samples, int numSamples)
+{
+  const int chunk = (int)vizBuffer.size();
+
+  for (int start = 0; start < numSamples; start += chunk)
+  {
+    int n = juce::jmin(chunk, numSamples - start);
+
+    for (int i = 0; i < n; ++i)
+      vizBuffer[i] = (float)samples[start + i];
+
+    const float* v = vizBuffer.data();
+    viz.pushBuffer(&v, 1, n);
+  }
+}
+
+/**
+ * @brief Tracks block time against the block's deadline (numSamples at the
+ *        rate given to prepareToPlay) and steps quality with hysteresis.
+ *        Load is smoothed with a fast rise and a slow fall, steps down need
+ *        a short dwell since the last step, steps up need a full second
+ *        under the low water mark. Transitions fade inside MoorerReverb.
+ * 
+ * @param seconds    time the block took
+ * @param numSamples samples in the block
+ */
+void ReverbPlayerAudioProcessor::updateQuality(double seconds, int numSamples)
+{
+  if (numSamples <= 0)
+    return;
+
+  int level = qualityLevel.load();
+  samplesInLevel[level].fetch_add(numSamples);
+
+  double load = seconds * currentRate / numSamples;
+  blockLoad += (load > blockLoad ? 0.5 : 0.05) * (load - blockLoad);
+  samplesSinceStep += numSamples;
+
+  int next = level;
+
+  if (!adaptiveQuality.load())
+    next = 0;
+  else if (blockLoad > loadHigh)
+  {
+    samplesUnderLoad = 0;
+
+    if (level < numQualityLevels - 1 && samplesSinceStep >= qualityDwellSeconds * currentRate)
+      next = level + 1;
+  }
+  else if (blockLoad < loadLow)
+  {
+    samplesUnderLoad += numSamples;
+
+    if (level > 0 && samplesUnderLoad >= qualityHoldSeconds * currentRate)
+      next = level - 1;
+  }
+  else
+    samplesUnderLoad = 0;
+
+  if (next == level)
+    return;
+
+  qualityLevel.store(next);
+  samplesSinceStep = 0;
+  samplesUnderLoad = 0;
+
+  applyQualityLevel(verbs[active.load()]);
+}
+
+/**
+ * @brief Sets a reverb's active combs/stages to the current quality level
+ * 
+ * @param verb reverb to change
+ */
+void ReverbPlayerAudioProcessor::applyQualityLevel(MoorerReverb& verb)
+{
+  const int level = qualityLevel.load();
+
+  verb.setQuality(qualityCombs[level], qualityStages[level]);
+}
+
+/**
+ * @brief Seconds of audio processed at a quality level since construction
+ * 
+ * @param level quality level (0 is full quality)
+ * 
+ * @return double 
+ */
+double ReverbPlayerAudioProcessor::getTimeInQualityLevel(int level) const
+{
+  if (level < 0 || level >= numQualityLevels)
+    return 0.0;
+
+  return (double)samplesInLevel[level].load() / currentRate;
 }
 
 /**
@@ -266,7 +1079,7 @@ double ReverbPlayerAudioProcessor::getTailLengthSeconds() const
  */
 int ReverbPlayerAudioProcessor::getNumPrograms()
 {
-  return 1;  
+  return numPresets;  
 }
 
 /**
@@ -276,7 +1089,7 @@ int ReverbPlayerAudioProcessor::getNumPrograms()
  */
 int ReverbPlayerAudioProcessor::getCurrentProgram()
 {
-  return 0;
+  return currentProgram;
 }
 
 /**
@@ -286,6 +1099,11 @@ int ReverbPlayerAudioProcessor::getCurrentProgram()
  */
 void ReverbPlayerAudioProcessor::setCurrentProgram (int index)
 {
+  if (index < 0 || index >= numPresets)
+    return;
+
+  currentProgram = index;
+  requestParameters(presets[index].params);
 }
 
 /**
@@ -296,24 +1114,78 @@ void ReverbPlayerAudioProcessor::setCurrentProgram (int index)
  */
 const juce::String ReverbPlayerAudioProcessor::getProgramName (int index)
 {
-  return {};
+  if (index < 0 || index >= numPresets)
+    return {};
+
+  return presets[index].name;
 }
 
 /**
- * @brief Gets state information
+ * @brief Gets state information, a fixed size little endian binary block of
+ *        the parameters the audio thread is running (params follows them,
+ *        synced every frame)
+ *
+ *   magic | version | program | mix | (g, ratio, L) * 6 | a | m | stages | nested
  * 
  * @param destData Reference to destination data
  */
 void ReverbPlayerAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
+  juce::MemoryOutputStream out(destData, false);
+
+  out.writeInt(stateMagic);
+  out.writeInt(stateVersion);
+  out.writeInt(currentProgram);
+  out.writeDouble(params.mix);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    out.writeDouble(params.g[i]);
+    out.writeDouble(params.ratio[i]);
+    out.writeDouble(params.L[i]);
+  }
+
+  out.writeDouble(params.a);
+  out.writeDouble(params.m);
+  out.writeInt(params.stages);
+  out.writeBool(params.nested);
 }
 
 /**
- * @brief Sets state information
+ * @brief Sets state information, switching to the restored parameters and
+ *        showing them on the host parameters (blocks that aren't ours, or
+ *        are truncated, are ignored)
  * 
  * @param data pointer to data
  * @param sizeInBytes size of data
  */
 void ReverbPlayerAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+  if (data == nullptr || sizeInBytes < stateSize)
+    return;
+
+  juce::MemoryInputStream in(data, (size_t)sizeInBytes, false);
+
+  if (in.readInt() != stateMagic || in.readInt() != stateVersion)
+    return;
+
+  MoorerParameters p;
+
+  int program = in.readInt();
+  p.mix = juce::jlimit(0.0, 1.0, in.readDouble());
+
+  for (int i = 0; i < 6; ++i)
+  {
+    p.g[i] = juce::jlimit(0.0, 1.0, in.readDouble());
+    p.ratio[i] = juce::jlimit(0.01, 1.0, in.readDouble());
+    p.L[i] = juce::jlimit(0.0, 100.0, in.readDouble());
+  }
+
+  p.a = juce::jlimit(0.0, 1.0, in.readDouble());
+  p.m = juce::jlimit(0.0, 100.0, in.readDouble());
+  p.stages = juce::jlimit(1, AllPassDiffuser::maxStages, in.readInt());
+  p.nested = in.readBool();
+
+  currentProgram = juce::jlimit(0, numPresets - 1, program);
+  requestParameters(p);
 }
\ No newline at end of file
@@ -4,7 +4,7 @@
  * @date   2022-03-17
  * @brief  Contains JUCE processor class and everything pertaining to it
  *
- * @note   This file contains base JUCE code. Modified 2022-06-12.
+ * @note   This file contains base JUCE code. Modified 2026-10-19.
  */
 
 #pragma once
@@ -13,6 +13,8 @@
 #include "../../MoorerReverb.h" 
 #include <string>
 #include <iostream>
+#include <array>
+#include <vector>
 
 /**
  * @brief Wrapper class for juce::AudioVisualiserComponent
@@ -30,21 +32,41 @@ public:
     setBufferSize(512);
     setSamplesPerBlock(96);
 
+    // same frame rate as the editor (component default is 60hz)
+    setRepaintRate(30);
+
     // set default colors
     juce::AudioVisualiserComponent::setColours(juce::Colours::black, juce::Colours::mediumpurple);
   }
 
   Visualizer(juce::Colour c1, juce::Colour c2) : AudioVisualiserComponent(2)
   {
+    setRepaintRate(30);
     juce::AudioVisualiserComponent::setColours(c1, c2);
   }
 };
 
+/**
+ * @brief Parameter change to be applied at a sample offset within a block,
+ *        coeff uses the editor's numbering (mix, R, g, L, ratio, a, m),
+ *        7 toggles bypass
+ * 
+ */
+struct ParameterEvent
+{
+  int sampleOffset;
+  int coeff;
+  int index;
+  double value;
+};
+
 /**
  * @brief Processor class
  * 
  */
-class ReverbPlayerAudioProcessor  : public juce::AudioProcessor
+class ReverbPlayerAudioProcessor  : public juce::AudioProcessor,
+                                    public juce::ChangeBroadcaster,
+                                    private juce::Timer
 {
 public:
 
@@ -61,6 +83,10 @@ public:
   juce::AudioProcessorValueTreeState& getState();
 
   void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+  void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+  // the reverb runs natively in double as well, no conversion in the host
+  bool supportsDoublePrecisionProcessing() const override { return true; }
 
   juce::AudioProcessorEditor* createEditor() override;
   bool hasEditor() const override;
@@ -92,13 +118,211 @@ public:
     return Viz2;
   }
 
-  // Moorer reverb object
-  MoorerReverb verb;
+  // queues a parameter change from the ui, applied at the start of the next block
+  // (message thread only), false if the queue is full and it has to be sent again
+  bool pushParameterEvent(int coeff, int index, double value);
+
+  // toggles bypass at the start of the next block (message thread only),
+  // false if the queue is full
+  bool toggleBypass() { return pushParameterEvent(7, 0, 0.0); }
+
+  // message thread copy of the parameters the audio thread is running, ui
+  // edits it hasn't picked up yet included (change messages are sent
+  // whenever a program or state load replaces them)
+  MoorerParameters getParameters() const { return params; }
+
+  // adaptive cpu quality scaling, steps down to fewer combs/diffuser stages
+  // when blocks run close to their deadline and back up once there's room
+  // (off by default, turning it off returns to full quality)
+  void setAdaptiveQuality(bool enabled) { adaptiveQuality.store(enabled); }
+  bool isAdaptiveQuality() const { return adaptiveQuality.load(); }
+
+  // quality levels, 0 is full quality
+  static const int numQualityLevels = 4;
+
+  // current level, and seconds of audio processed at a level (any thread)
+  int getQualityLevel() const { return qualityLevel.load(); }
+  double getTimeInQualityLevel(int level) const;
+
+  // MIDI CC numbers mapped to mix, and g/R/L of each comb (6 CCs each)
+  static const int ccMix = 20;
+  static const int ccFirstG = 21;
+  static const int ccFirstR = 27;
+  static const int ccFirstL = 33;
 
 private:
 
+  // program switch progress, the standby reverb is owned by the message
+  // thread while Preparing, and by the audio thread from Ready on. While
+  // Spilling the outgoing reverb's tail rings out on silence next to the
+  // incoming one.
+  enum SwitchState { Idle, Preparing, Ready, Spilling };
+
+  // configures the standby reverb and hands it to the audio thread to
+  // switch to, false if a switch is already in flight
+  bool prepareSwitch(const MoorerParameters& p);
+
+  // prepares a switch now, or retries from the timer until one can start
+  // (cutting a spilling tail short so the next switch doesn't wait on it)
+  void requestParameters(const MoorerParameters& p);
+
+  // makes the prepared reverb active and starts the outgoing one's spill
+  // (audio thread, or prepareToPlay while audio is stopped)
+  void startSwitch();
+
+  // retries a queued switch and syncs parameters, once a frame
+  void timerCallback() override;
+
+  // takes the audio thread's latest parameters into the message thread copy
+  // (replaying ui edits it hasn't picked up yet) and shows them on the host
+  // parameters (message thread)
+  void syncParameters();
+
+  // hands the live parameters to the message thread (audio thread)
+  void publishLive();
+
+  // shared body of both processBlock overloads
+  template <class Sample>
+  void processSamples(juce::AudioBuffer<Sample>& buffer, juce::MidiBuffer& midiMessages);
+
+  // runs a span of the input through the active reverb into every output,
+  // starting at offset (adding the outgoing reverb's tail while a switch is
+  // spilling)
+  template <class Sample>
+  void processSpan(const Sample* in, Sample* const* outs, int numOuts, int offset, int numSamples);
+
+  // spill scratch matching the block's sample type
+  float* getSpillBuffer(float*) { return spillBuffer.data(); }
+  double* getSpillBuffer(double*) { return spillBufferDouble.data(); }
+
+  // pushes one channel to a visualizer (double is converted, display only)
+  void pushVisualizer(Visualizer& viz, const float* samples, int numSamples);
+  void pushVisualizer(Visualizer& viz, const double* samples, int numSamples);
+
+  // measures a block against its deadline and steps quality (audio thread)
+  void updateQuality(double seconds, int numSamples);
+
+  // sets a reverb's combs/stages to the current quality level
+  void applyQualityLevel(MoorerReverb& verb);
+
+  // gathers ui, host automation (block accurate, ramped) and MIDI CC events
+  // for this block in time order
+  void collectParameterEvents(juce::MidiBuffer& midiMessages, int numSamples);
+
+  // applies a single event to a reverb (audio thread)
+  void applyParameterEvent(MoorerReverb& verb, const ParameterEvent& e);
+
+  // a host (APVTS) parameter, its raw value, the value the audio thread last
+  // took from it, and the value the message thread last wrote to it (so the
+  // audio thread doesn't take its own parameters back as automation)
+  struct HostParameter
+  {
+    std::atomic<float>* raw = nullptr;
+    juce::RangedAudioParameter* param = nullptr;
+    float last = 0.0f;
+    std::atomic<float> echo { -2.0f };
+  };
+
+  // echo while the message thread is writing, and once it has been seen
+  static constexpr float echoBusy = -1.0f;
+  static constexpr float echoNone = -2.0f;
+
+  // binds a host parameter by id
+  void attachHostParameter(HostParameter& h, const juce::String& id);
+
+  // queues events if a host parameter moved since the last block, ramped
+  // over the block in steps events
+  void checkHostParameter(HostParameter& h, int coeff, int index, double scale, int numSamples, int steps);
+
+  // writes a live value to a host parameter unless it already shows it
+  // (to the parameter's resolution)
+  void pushHostParameter(HostParameter& h, double value);
+
   juce::AudioProcessorValueTreeState* pState;
 
+  // Moorer reverb objects, the active one and a standby that program changes
+  // are prepared in before being switched to
+  MoorerReverb verbs[2];
+  std::atomic<int> active { 0 };
+  std::atomic<int> switchState { Idle };
+
+  // parameters of the switch handed over (written while Preparing), and a
+  // request to cut a spilling tail short
+  MoorerParameters switchParams;
+  std::atomic<bool> releaseSpill { false };
+
+  // dry level crossfade into the incoming reverb (samples), the outgoing
+  // reverb's dry level, samples spilled, samples in a row the spill has
+  // been silent, and the fade a spill is cut short with
+  int fadeLength = 240;
+  int fadePos = 0;
+  double fadeDry = 0.8;
+  juce::int64 spillPos = 0;
+  int spillQuiet = 0;
+  bool releasing = false;
+  int releasePos = 0;
+  int releaseLength = 2400;
+  std::vector<float> spillBuffer;
+  std::vector<double> spillBufferDouble;
+
+  // float copy of double blocks for the visualizers
+  std::vector<float> vizBuffer;
+
+  // quality scaling state, smoothed block time / deadline, samples spent
+  // since the last step and under the low water mark, and per level totals
+  std::atomic<bool> adaptiveQuality { false };
+  std::atomic<int> qualityLevel { 0 };
+  double blockLoad = 0.0;
+  int samplesSinceStep = 0;
+  int samplesUnderLoad = 0;
+  std::atomic<juce::int64> samplesInLevel[numQualityLevels] { };
+  double currentRate = 48000.0;
+
+  // message thread parameter mirror, current program and switch waiting to start
+  MoorerParameters params;
+  int currentProgram = 0;
+  MoorerParameters pendingParams;
+  bool hasPending = false;
+
+  // ui -> audio thread events (single producer, single consumer)
+  static const int uiFifoSize = 256;
+  juce::AbstractFifo uiFifo { uiFifoSize };
+  std::array<ParameterEvent, uiFifoSize> uiEvents;
+
+  // parameters the audio thread is running, with how many ui events and
+  // switches it has applied to get there
+  struct LiveParameters
+  {
+    MoorerParameters params;
+    juce::uint32 uiApplied;
+    juce::uint32 switchesApplied;
+  };
+
+  // audio thread copy, and whether it changed this block
+  LiveParameters live;
+  bool liveChanged = false;
+
+  // triple buffer handing live to the message thread, the audio thread
+  // writes liveBack, the message thread reads liveFront, liveLatest holds
+  // the newest (liveFresh set until it's taken)
+  static const int liveFresh = 4;
+  LiveParameters liveSlots[3];
+  std::atomic<int> liveLatest { 1 };
+  int liveBack = 0, liveFront = 2;
+
+  // ui events queued and switches handed over (message thread), and every
+  // queued event by sequence number (replayed until the audio thread has it)
+  juce::uint32 uiPushed = 0;
+  juce::uint32 switchesRequested = 0;
+  std::array<ParameterEvent, uiFifoSize> uiSent;
+
+  // events for the block being processed (storage reserved up front)
+  std::vector<ParameterEvent> blockEvents;
+
+  // host parameters
+  HostParameter hostMix;
+  HostParameter hostG[6], hostR[6], hostL[6];
+
   Visualizer Viz1, Viz2;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbPlayerAudioProcessor)
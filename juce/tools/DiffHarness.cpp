@@ -0,0 +1,997 @@
+/**
+ * @file   DiffHarness.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Differential harness, runs the reference filters and every
+ *         optimized variant over a corpus of impulses, noise and sweeps at
+ *         several rates and reports max error, SNR and speedup in one table.
+ *         Also reports how fixed point comb tails degrade against double,
+ *         checks the sub-band QMF and compares sub-band reverb cost/decay
+ *         to fullband, checks that a reverb bank split across a worker
+ *         pool matches the serial bank (and reports per thread load),
+ *         benchmarks the velvet noise reverb's cost per second of tail
+ *         against the comb bank, and checks that a decaying tail keeps a
+ *         flat per block cost.
+ *
+ *         g++ -std=c++17 -O2 -pthread -I.. DiffHarness.cpp ReferenceFilters.cpp ../DelayArena.cpp ../Filters.cpp
+ *             ../Followers.cpp ../LongDelay.cpp ../MoorerReverb.cpp ../ReverbBank.cpp ../Subbands.cpp
+ *             ../VelvetReverb.cpp ../WorkerPool.cpp -o diffharness
+ *         ./diffharness [--seconds 2] [--tail-minutes 2] [--no-tail]
+ *
+ *         Exits non-zero if any variant is outside its tolerance.
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "ReferenceFilters.h"
+#include "../Filters.h"
+#include "../FixedFilters.h"
+#include "../MoorerReverb.h"
+#include "../LongDelay.h"
+#include "../ReverbBank.h"
+#include "../Subbands.h"
+#include "../VelvetReverb.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// runs a filter over in, writing out (same length)
+using Kernel = std::function<void(const std::vector<float>& in, std::vector<float>& out, int rate)>;
+
+/**
+ * @brief Optimized implementation compared against its group's reference,
+ *        tolerance is the largest absolute error accepted (0 = bit exact)
+ *
+ */
+struct Variant
+{
+  const char* name;
+  double tolerance;
+  Kernel run;
+};
+
+/**
+ * @brief Reference kernel and every variant that has to match it
+ *
+ */
+struct Group
+{
+  const char* name;
+  Kernel reference;
+  std::vector<Variant> variants;
+};
+
+/**
+ * @brief Named test signal
+ *
+ */
+struct Signal
+{
+  const char* name;
+  std::vector<float> samples;
+};
+
+static const int rates[] = { 44100, 48000, 96000 };
+
+// comb/allpass settings used by the single filter groups
+static const double combMs = 50.0, combG = 0.46, combRatio = 0.83;
+static const double allpassMs = 6.0, allpassA = 0.7;
+
+// delay used by the delay line group, long enough to reach compact storage
+static const double delayMs = 500.0;
+
+// same algorithm as the reference, the only difference allowed is state
+// below 1e-30 being flushed to zero (denormal protection)
+static const double exact = 1e-20;
+
+// same transfer function computed another way, one float ulp of rounding
+static const double rounding = 1e-6;
+
+// fixed point kernels, a few lsbs of their sample format (Q3.12 / Q3.28)
+static const double q3_12 = 5e-3;
+static const double q3_28 = 1e-6;
+
+/**
+ * @brief Impulse, white noise and a 20hz - nyquist log sweep
+ *
+ * @param rate    sampling rate
+ * @param seconds length of every signal
+ *
+ * @return std::vector<Signal>
+ */
+static std::vector<Signal> makeCorpus(int rate, double seconds)
+{
+  const int n = (int)(rate * seconds);
+  std::vector<Signal> corpus;
+
+  std::vector<float> impulse(n, 0.0f);
+  impulse[0] = 1.0f;
+  corpus.push_back({ "impulse", impulse });
+
+  // fixed seed so every run sees the same noise
+  std::vector<float> noise(n);
+  uint32_t seed = 0x1234567u;
+  for (int i = 0; i < n; ++i)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    noise[i] = (float)((seed >> 8) / 16777216.0 - 0.5);
+  }
+  corpus.push_back({ "noise", noise });
+
+  std::vector<float> sweep(n);
+  const double f0 = 20.0, f1 = rate * 0.5;
+  const double k = std::log(f1 / f0);
+  for (int i = 0; i < n; ++i)
+  {
+    double t = (double)i / n;
+    sweep[i] = (float)(0.5 * std::sin(2.0 * 3.14159265358979323846 * f0 * seconds / k * (std::exp(t * k) - 1.0)));
+  }
+  corpus.push_back({ "sweep", sweep });
+
+  return corpus;
+}
+
+static int toSamples(double ms, int rate) { return (int)std::round(ms * 0.001 * rate); }
+
+/**
+ * @brief Sets up an optimized reverb to match the reference (single stage
+ *        diffuser, which is the original allpass)
+ *
+ */
+static void setupMoorer(MoorerReverb& verb, int rate)
+{
+  verb.setRate(rate);
+  verb.setMix(0.2);
+  verb.initializeFilters();
+  verb.setDiffusion(1, false);
+}
+
+/**
+ * @brief Every group and variant checked by the harness, add new optimized
+ *        kernels here
+ *
+ */
+static std::vector<Group> makeGroups()
+{
+  std::vector<Group> groups;
+
+  // ---- lowpass-comb ----
+  groups.push_back({ "LowPassComb",
+    [](const std::vector<float>& in, std::vector<float>& out, int rate)
+    {
+      reference::LowPassComb c;
+      c.setCoefficients(combRatio, combG);
+      c.setDelay(toSamples(combMs, rate));
+      for (size_t i = 0; i < in.size(); ++i)
+        out[i] = c(in[i]);
+    },
+    {
+      { "per sample", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          LowPassComb c;
+          c.setCoefficients(combRatio, combG);
+          c.setDelay(toSamples(combMs, rate));
+          for (size_t i = 0; i < in.size(); ++i)
+            out[i] = c(in[i]);
+        } },
+      { "block", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          LowPassComb c;
+          c.setCoefficients(combRatio, combG);
+          c.setDelay(toSamples(combMs, rate));
+          out = in;
+          c.process(out.data(), (int)out.size());
+        } },
+      { "arena", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          DelayArena arena;
+          int maxL = toSamples(100.0, rate);
+          arena.allocate(LowPassComb::memoryNeeded(maxL));
+
+          LowPassComb c;
+          c.attach(arena, maxL);
+          c.setCoefficients(combRatio, combG);
+          c.setDelay(toSamples(combMs, rate));
+          out = in;
+          c.process(out.data(), (int)out.size());
+        } },
+      { "fixed Q3.12 block", q3_12, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          LowPassCombQ3_12 c;
+          c.setCoefficients(combRatio, combG);
+          c.setDelay(toSamples(combMs, rate));
+          out = in;
+          c.process(out.data(), (int)out.size());
+        } },
+      { "fixed Q3.28 block", q3_28, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          LowPassCombQ3_28 c;
+          c.setCoefficients(combRatio, combG);
+          c.setDelay(toSamples(combMs, rate));
+          out = in;
+          c.process(out.data(), (int)out.size());
+        } },
+    } });
+
+  // ---- allpass ----
+  groups.push_back({ "AllPass",
+    [](const std::vector<float>& in, std::vector<float>& out, int rate)
+    {
+      reference::AllPass ap;
+      ap.setCoefficient(allpassA);
+      ap.setDelay(toSamples(allpassMs, rate));
+      for (size_t i = 0; i < in.size(); ++i)
+        out[i] = ap(in[i]);
+    },
+    {
+      { "per sample", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          AllPass ap;
+          ap.setCoefficient(allpassA);
+          ap.setDelay(toSamples(allpassMs, rate));
+          for (size_t i = 0; i < in.size(); ++i)
+            out[i] = ap(in[i]);
+        } },
+      { "diffuser 1 stage", rounding, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          AllPassDiffuser d;
+          d.setStages(1, false);
+          d.setCoefficient(allpassA);
+          d.setDelay(toSamples(allpassMs, rate));
+          out = in;
+          d.process(out.data(), (int)out.size());
+        } },
+      { "fixed Q3.12 block", q3_12, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          AllPassQ3_12 ap;
+          ap.setCoefficient(allpassA);
+          ap.setDelay(toSamples(allpassMs, rate));
+          out = in;
+          ap.process(out.data(), (int)out.size());
+        } },
+      { "fixed Q3.28 block", q3_28, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          AllPassQ3_28 ap;
+          ap.setCoefficient(allpassA);
+          ap.setDelay(toSamples(allpassMs, rate));
+          out = in;
+          ap.process(out.data(), (int)out.size());
+        } },
+    } });
+
+  // ---- moorer reverb ----
+  groups.push_back({ "MoorerReverb",
+    [](const std::vector<float>& in, std::vector<float>& out, int rate)
+    {
+      reference::MoorerReverb verb(rate, 0.2);
+      for (size_t i = 0; i < in.size(); ++i)
+        out[i] = verb(in[i]);
+    },
+    {
+      { "per sample", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          MoorerReverb verb;
+          setupMoorer(verb, rate);
+          for (size_t i = 0; i < in.size(); ++i)
+            out[i] = verb(in[i]);
+        } },
+      { "block", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          MoorerReverb verb;
+          setupMoorer(verb, rate);
+          out = in;
+          verb.process(out.data(), (int)out.size());
+        } },
+      { "stereo out", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          // both outputs must carry the same signal, report the worse one
+          MoorerReverb verb;
+          setupMoorer(verb, rate);
+          std::vector<float> right(in.size());
+          float* outs[2] = { out.data(), right.data() };
+          verb.process(in.data(), outs, 2, (int)in.size());
+
+          for (size_t i = 0; i < in.size(); ++i)
+            if (right[i] != out[i])
+              out[i] = 1e9f;
+        } },
+      { "double", rounding, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          MoorerReverb verb;
+          setupMoorer(verb, rate);
+          std::vector<double> x(in.begin(), in.end());
+          double* outs[1] = { x.data() };
+          verb.process(x.data(), outs, 1, (int)x.size());
+
+          for (size_t i = 0; i < in.size(); ++i)
+            out[i] = (float)x[i];
+        } },
+      { "checkpoint resume", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          // split the render, move the state through a checkpoint into a
+          // reverb configured differently, and finish the render there
+          int split = (int)in.size() / 3;
+          out = in;
+
+          MoorerReverb first;
+          setupMoorer(first, rate);
+          first.process(out.data(), split);
+
+          std::vector<unsigned char> image(first.getCheckpointSize());
+          first.saveCheckpoint(image.data(), image.size());
+
+          MoorerReverb second;
+          second.setRate(rate == 96000 ? 44100 : 96000);
+          second.initializeFilters();
+
+          if (!second.loadCheckpoint(image.data(), image.size()))
+          {
+            std::fill(out.begin(), out.end(), 1e9f);
+            return;
+          }
+
+          second.process(out.data() + split, (int)out.size() - split);
+        } },
+      { "fixed Q3.12 combs", q3_12, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          MoorerReverb verb;
+          setupMoorer(verb, rate);
+          verb.setCombFormat(MoorerReverb::FixedQ3_12);
+          out = in;
+          verb.process(out.data(), (int)out.size());
+        } },
+      { "fixed Q3.28 combs", q3_28, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          MoorerReverb verb;
+          setupMoorer(verb, rate);
+          verb.setCombFormat(MoorerReverb::FixedQ3_28);
+          out = in;
+          verb.process(out.data(), (int)out.size());
+        } },
+    } });
+
+  // ---- delay lines (integer delays, fractional reads at integer positions) ----
+  groups.push_back({ "DelayLine",
+    [](const std::vector<float>& in, std::vector<float>& out, int rate)
+    {
+      std::queue<double> q;
+      for (int i = 0; i < toSamples(delayMs, rate); ++i)
+        q.push(0.0);
+      for (size_t i = 0; i < in.size(); ++i)
+      {
+        out[i] = (float)q.front();
+        q.pop();
+        q.push(in[i]);
+      }
+    },
+    {
+      { "ring read", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          int d = toSamples(delayMs, rate);
+          DelayLine line;
+          line.reserve(d + 1);
+          for (size_t i = 0; i < in.size(); ++i)
+          {
+            out[i] = (float)line.read(d);
+            line.write(in[i]);
+          }
+        } },
+      { "ring readLinear", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          int d = toSamples(delayMs, rate);
+          DelayLine line;
+          line.reserve(d + 2);
+          for (size_t i = 0; i < in.size(); ++i)
+          {
+            out[i] = (float)line.readLinear(d);
+            line.write(in[i]);
+          }
+        } },
+      { "long full", exact, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          int d = toSamples(delayMs, rate);
+          LongDelayLine line;
+          line.prepare(d + 2, LongDelayLine::Full, 1 << 12, 1 << 10);
+          for (size_t i = 0; i < in.size(); ++i)
+          {
+            out[i] = (float)line.read(d);
+            line.write(in[i]);
+          }
+        } },
+      { "long int16", 1e-3, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          int d = toSamples(delayMs, rate);
+          LongDelayLine line;
+          line.prepare(d + 2, LongDelayLine::Int16, 1 << 12, 1 << 10);
+          for (size_t i = 0; i < in.size(); ++i)
+          {
+            out[i] = (float)line.read(d);
+            line.write(in[i]);
+          }
+        } },
+      { "long half", 1e-3, [](const std::vector<float>& in, std::vector<float>& out, int rate)
+        {
+          int d = toSamples(delayMs, rate);
+          LongDelayLine line;
+          line.prepare(d + 2, LongDelayLine::Half, 1 << 12, 1 << 10);
+          for (size_t i = 0; i < in.size(); ++i)
+          {
+            out[i] = (float)line.readLinear(d);
+            line.write(in[i]);
+          }
+        } },
+    } });
+
+  return groups;
+}
+
+/**
+ * @brief Runs a kernel, returning how long it took (seconds)
+ *
+ */
+static double timeKernel(const Kernel& k, const std::vector<float>& in, std::vector<float>& out, int rate)
+{
+  out.assign(in.size(), 0.0f);
+
+  auto start = std::chrono::steady_clock::now();
+  k(in, out, rate);
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Feeds an impulse followed by minutes of silence through the
+ *        reverb and compares per block cost across the tail (denormals
+ *        show up as blocks getting slower as the tail decays)
+ *
+ * @param minutes length of the tail
+ *
+ * @return true if the slowest tenth of the tail is under 2x the fastest
+ */
+static bool runTail(double minutes)
+{
+  const int rate = 48000, block = 256;
+  const int blocks = (int)(minutes * 60.0 * rate / block);
+  const int windows = 10;
+
+  if (blocks < windows)
+    return true;
+
+  MoorerReverb verb;
+  setupMoorer(verb, rate);
+
+  std::vector<double> windowTime(windows, 0.0);
+  float buffer[block];
+
+  for (int b = 0; b < blocks; ++b)
+  {
+    std::memset(buffer, 0, sizeof(buffer));
+    if (b == 0)
+      buffer[0] = 1.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    verb.process(buffer, block);
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int w = b * windows / blocks;
+    windowTime[w] += t;
+  }
+
+  double fastest = windowTime[0], slowest = windowTime[0];
+  for (double t : windowTime)
+  {
+    fastest = t < fastest ? t : fastest;
+    slowest = t > slowest ? t : slowest;
+  }
+
+  const double perWindow = (double)blocks / windows;
+  bool flat = slowest < 2.0 * fastest;
+
+  std::printf("\ntail: impulse + %.1f min silence, %d sample blocks at %d hz\n", minutes, block, rate);
+  std::printf("  us/block per tenth:");
+  for (double t : windowTime)
+    std::printf(" %.2f", t / perWindow * 1e6);
+  std::printf("\n  slowest/fastest %.2f  %s\n", slowest / fastest, flat ? "ok" : "FAIL");
+
+  return flat;
+}
+
+/**
+ * @brief Impulse response of the double comb vs the fixed point combs, SNR
+ *        per tenth of the tail, showing how far into the decay each format
+ *        keeps up (rounding noise takes over as the tail nears the lsb)
+ *
+ * @param seconds length of the impulse response
+ */
+static void runFixedTail(double seconds)
+{
+  const int rate = 48000;
+  const int n = (int)(seconds * rate);
+  const int windows = 10;
+
+  if (n < windows)
+    return;
+
+  std::vector<float> impulse(n, 0.0f), expected, q12out, q28out;
+  impulse[0] = 1.0f;
+
+  Kernel reference = [](const std::vector<float>& in, std::vector<float>& out, int r)
+  {
+    reference::LowPassComb c;
+    c.setCoefficients(combRatio, combG);
+    c.setDelay(toSamples(combMs, r));
+    for (size_t i = 0; i < in.size(); ++i)
+      out[i] = c(in[i]);
+  };
+
+  timeKernel(reference, impulse, expected, rate);
+
+  auto runFixed = [&](Filter& f, std::vector<float>& out)
+  {
+    out = impulse;
+    f.process(out.data(), n);
+  };
+
+  LowPassCombQ3_12 c12;
+  c12.setCoefficients(combRatio, combG);
+  c12.setDelay(toSamples(combMs, rate));
+  runFixed(c12, q12out);
+
+  LowPassCombQ3_28 c28;
+  c28.setCoefficients(combRatio, combG);
+  c28.setDelay(toSamples(combMs, rate));
+  runFixed(c28, q28out);
+
+  std::printf("\nfixed point tail: comb impulse response vs double, SNR (dB) per tenth of %.1fs\n", seconds);
+  std::printf("  %-6s %9s %9s %9s\n", "tenth", "level", "Q3.12", "Q3.28");
+
+  for (int w = 0; w < windows; ++w)
+  {
+    double signal = 0.0, noise12 = 0.0, noise28 = 0.0;
+
+    for (int i = w * n / windows; i < (w + 1) * n / windows; ++i)
+    {
+      signal += (double)expected[i] * expected[i];
+      noise12 += ((double)q12out[i] - expected[i]) * ((double)q12out[i] - expected[i]);
+      noise28 += ((double)q28out[i] - expected[i]) * ((double)q28out[i] - expected[i]);
+    }
+
+    const double len = (double)n / windows;
+    std::printf("  %-6d %9.1f %9.1f %9.1f\n", w + 1, 10.0 * std::log10(signal / len + 1e-300),
+                10.0 * std::log10((signal + 1e-300) / (noise12 + 1e-300)),
+                10.0 * std::log10((signal + 1e-300) / (noise28 + 1e-300)));
+  }
+}
+
+/**
+ * @brief Sub-band mode. Checks that a QMF split + merge is an allpass (an
+ *        impulse keeps its energy), then compares per block cost and decay
+ *        (impulse response level per 0.25s) of 2 - 4 bands against fullband
+ *
+ * @return true if the QMF reconstructs
+ */
+static bool runSubbands()
+{
+  const int rate = 48000, block = 256, blocks = 4000;
+  const int n = 1 << 14;
+
+  std::vector<double> impulse(n, 0.0), low(n / 2), high(n / 2), rebuilt(n);
+  impulse[0] = 1.0;
+
+  HalfbandQmf qmf;
+  qmf.split(impulse.data(), low.data(), high.data(), n / 2);
+  qmf.merge(low.data(), high.data(), rebuilt.data(), n / 2);
+
+  double energy = 0.0;
+  for (double v : rebuilt)
+    energy += v * v;
+
+  bool ok = std::fabs(energy - 1.0) < 1e-9;
+
+  std::printf("\nsub-band: qmf split + merge energy %.12f  %s\n", energy, ok ? "ok" : "FAIL");
+  std::printf("  %-6s %9s %7s  %s\n", "bands", "us/block", "cost", "level (dB) per 0.25s of the impulse response");
+
+  double fullband = 0.0;
+
+  for (int bands = 1; bands <= 4; ++bands)
+  {
+    MoorerReverb verb;
+    setupMoorer(verb, rate);
+    verb.setMix(1.0);
+    verb.setSubbands(bands);
+
+    std::vector<float> ir(2 * rate, 0.0f);
+    ir[0] = 1.0f;
+    verb.process(ir.data(), (int)ir.size());
+    verb.reset();
+
+    std::vector<float> noise = makeCorpus(rate, (double)block / rate)[1].samples;
+    noise.resize(block);
+
+    std::vector<float> buffer(block);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; ++b)
+    {
+      std::copy(noise.begin(), noise.end(), buffer.begin());
+      verb.process(buffer.data(), block);
+    }
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / blocks;
+
+    if (bands == 1)
+      fullband = t;
+
+    std::printf("  %-6d %9.2f %+6.0f%% ", bands, t * 1e6, 100.0 * (t / fullband - 1.0));
+
+    const int window = rate / 4;
+    for (int w = 0; w < (int)ir.size() / window; ++w)
+    {
+      double e = 0.0;
+      for (int i = w * window; i < (w + 1) * window; ++i)
+        e += (double)ir[i] * ir[i];
+      std::printf(" %6.1f", 10.0 * std::log10(e + 1e-30));
+    }
+    std::printf("\n");
+  }
+
+  return ok;
+}
+
+/**
+ * @brief Reverb bank. Runs the same voices in series and across a worker
+ *        pool (one worker per spare core, at least one), checks the pooled
+ *        output is bit exact, and reports cost per block and each thread's
+ *        load. Block time is charged against real time, so on a machine
+ *        with fewer cores than workers the pooled cost only shows overhead.
+ *
+ * @return true if the pooled bank matches the serial one
+ */
+static bool runBank()
+{
+  const int rate = 48000, block = 256, voices = 64, blocks = 200;
+
+  int workers = (int)std::thread::hardware_concurrency() - 1;
+  workers = workers < 1 ? 1 : workers;
+
+  MoorerReverbBank serial, pooled;
+  serial.prepare(voices, rate);
+  pooled.prepare(voices, rate);
+
+  for (int v = 0; v < voices; ++v)
+  {
+    serial.getVoice(v).setMix(1.0);
+    pooled.getVoice(v).setMix(1.0);
+  }
+
+  WorkerPool pool;
+  pool.start(workers);
+
+  // a different noise burst per voice, then silence so the tails run
+  std::vector<float> noise = makeCorpus(rate, 0.5)[1].samples;
+  std::vector<std::vector<float>> a(voices, std::vector<float>(block)), b = a;
+  std::vector<float*> pa(voices), pb(voices);
+  for (int v = 0; v < voices; ++v)
+  {
+    pa[v] = a[v].data();
+    pb[v] = b[v].data();
+  }
+
+  double maxError = 0.0, serialTime = 0.0, pooledTime = 0.0;
+
+  for (int k = 0; k < blocks; ++k)
+  {
+    for (int v = 0; v < voices; ++v)
+      for (int i = 0; i < block; ++i)
+      {
+        int n = k * block + i;
+        a[v][i] = b[v][i] = n < rate / 10 ? noise[(n + v * 997) % noise.size()] : 0.0f;
+      }
+
+    auto start = std::chrono::steady_clock::now();
+    serial.process(pa.data(), block);
+    auto mid = std::chrono::steady_clock::now();
+    pooled.process(pb.data(), block, pool);
+    auto end = std::chrono::steady_clock::now();
+
+    serialTime += std::chrono::duration<double>(mid - start).count();
+    pooledTime += std::chrono::duration<double>(end - mid).count();
+
+    for (int v = 0; v < voices; ++v)
+      for (int i = 0; i < block; ++i)
+        maxError = std::fabs(a[v][i] - b[v][i]) > maxError ? std::fabs(a[v][i] - b[v][i]) : maxError;
+  }
+
+  bool ok = maxError == 0.0;
+
+  std::printf("\nreverb bank: %d voices, %d block, pool of %d workers + caller\n", voices, block, workers);
+  std::printf("  serial %9.2f us/block   pooled %9.2f us/block   (block is %.0f us)   max error %g  %s\n",
+              serialTime / blocks * 1e6, pooledTime / blocks * 1e6, 1e6 * block / rate, maxError, ok ? "ok" : "FAIL");
+  std::printf("  load per thread (caller first):");
+  for (int t = 0; t <= pool.getNumWorkers(); ++t)
+    std::printf(" %.2f", pool.getLoad(t));
+  std::printf("   overruns %llu   stalls per worker:", (unsigned long long)pool.getOverruns());
+  for (int t = 1; t <= pool.getNumWorkers(); ++t)
+    std::printf(" %llu", (unsigned long long)pool.getStalls(t));
+  std::printf("\n");
+
+  pool.stop();
+
+  return ok;
+}
+
+/**
+ * @brief Velvet noise reverb. Checks the tail doesn't depend on block size
+ *        (a block of one against uneven blocks, bit exact), then times the
+ *        Moorer reverb and velvet tails of several lengths and densities
+ *        over noise. Comb cost is flat, velvet cost grows with pulses, so
+ *        each velvet row is also given as a multiple of the Moorer row.
+ *
+ * @return true if blocking doesn't change the velvet output
+ */
+static bool runVelvet()
+{
+  const int rate = 48000, block = 256, blocks = 1000;
+
+  std::vector<float> noise = makeCorpus(rate, (double)block * blocks / rate)[1].samples;
+  noise.resize((size_t)block * blocks);
+
+  VelvetReverb single(rate, 0.5), blocked(rate, 0.5);
+  std::vector<float> a(noise.begin(), noise.begin() + rate), b = a;
+
+  for (float& x : a)
+    x = single(x);
+
+  const int sizes[] = { 1, 17, 128, 256, 1000 };
+  for (int pos = 0, k = 0; pos < (int)b.size(); ++k)
+  {
+    int n = std::min(sizes[k % 5], (int)b.size() - pos);
+    blocked.process(b.data() + pos, n);
+    pos += n;
+  }
+
+  double maxError = 0.0;
+  for (size_t i = 0; i < a.size(); ++i)
+    maxError = std::fabs(a[i] - b[i]) > maxError ? std::fabs(a[i] - b[i]) : maxError;
+
+  bool ok = maxError == 0.0;
+
+  std::printf("\nvelvet reverb: block size independence, max error %g  %s\n", maxError, ok ? "ok" : "FAIL");
+  std::printf("  %-8s %8s %8s %8s %10s %14s %8s\n", "engine", "tail (s)", "pulses/s", "pulses", "us/block", "us/block per s",
+              "x moorer");
+
+  auto time = [&](Filter& f)
+  {
+    std::vector<float> buffer = noise;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < blocks; ++k)
+      f.process(buffer.data() + (size_t)k * block, block);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / blocks * 1e6;
+  };
+
+  MoorerReverb moorer;
+  setupMoorer(moorer, rate);
+  moorer.setDiffusion(4, false);
+  const double moorerTime = time(moorer);
+  std::printf("  %-8s %8s %8s %8s %10.2f %14s %8s\n", "moorer", "-", "-", "-", moorerTime, "-", "1.00");
+
+  for (double density : { 1000.0, 2000.0 })
+    for (double seconds : { 0.5, 1.0, 2.0, 4.0 })
+    {
+      VelvetReverb velvet;
+      velvet.setRate(rate);
+      velvet.setDensity(density);
+      velvet.setDecay(seconds);
+      velvet.generatePulses();
+
+      double t = time(velvet);
+      std::printf("  %-8s %8.1f %8.0f %8d %10.2f %14.2f %8.2f\n", "velvet", seconds, density, velvet.getNumPulses(), t,
+                  t / seconds, t / moorerTime);
+    }
+
+  return ok;
+}
+
+/**
+ * @brief Sidechain. Ducking: a loud sidechain at full depth has to pull
+ *        the wet tail down. Pitch tuning: with a 220hz sine on the
+ *        sidechain every comb has to settle within a sample of a whole
+ *        number of periods, still report its own delay, and go back to it
+ *        once the sidechain is gone. Also times a block with and without
+ *        the sidechain.
+ *
+ * @return true if ducking and pitch tuning behave
+ */
+static bool runSidechain()
+{
+  const int rate = 48000, block = 64, blocks = rate / block;
+  const double f = 220.0, period = rate / f;
+
+  std::vector<float> noise = makeCorpus(rate, 1.0)[1].samples;
+  noise.resize((size_t)block * blocks);
+
+  std::vector<float> sine(noise.size());
+  for (size_t i = 0; i < sine.size(); ++i)
+    sine[i] = (float)(0.5 * std::sin(2.0 * 3.14159265358979323846 * f * i / rate));
+
+  // wet energy of the last half, with and without a ducking sidechain
+  auto wetEnergy = [&](const float* sidechainIn)
+  {
+    MoorerReverb verb;
+    setupMoorer(verb, rate);
+    verb.setMix(1.0);
+    verb.setDucking(1.0);
+
+    std::vector<float> out = noise;
+    for (int b = 0; b < blocks; ++b)
+      verb.process(out.data() + (size_t)b * block, sidechainIn ? sidechainIn + (size_t)b * block : nullptr, block);
+
+    double e = 0.0;
+    for (size_t i = out.size() / 2; i < out.size(); ++i)
+      e += (double)out[i] * out[i];
+    return e;
+  };
+
+  double ducked = 10.0 * std::log10(wetEnergy(sine.data()) / wetEnergy(nullptr));
+  bool duckOk = ducked < -3.0;
+
+  std::printf("\nsidechain: ducking at full depth %.1f dB  %s\n", ducked, duckOk ? "ok" : "FAIL");
+
+  MoorerReverb verb;
+  setupMoorer(verb, rate);
+  verb.setPitchTuning(1.0);
+
+  MoorerParameters own = verb.getParameters();
+  std::vector<float> out = noise;
+  int settled = -1;
+
+  for (int b = 0; b < blocks; ++b)
+  {
+    verb.process(out.data() + (size_t)b * block, sine.data() + (size_t)b * block, block);
+
+    double worst = 0.0;
+    for (int c = 0; c < 6; ++c)
+    {
+      double L = verb.lp_combs[c].L;
+      worst = std::max(worst, std::fabs(L - std::round(L / period) * period));
+    }
+
+    if (worst > 1.0)
+      settled = -1;
+    else if (settled < 0)
+      settled = (b + 1) * block;
+  }
+
+  bool tuned = settled >= 0;
+  bool reported = true;
+  MoorerParameters p = verb.getParameters();
+
+  for (int c = 0; c < 6; ++c)
+    reported = reported && p.L[c] == own.L[c];
+
+  std::printf("  pitch tuning to %.0fhz: delays (samples)", f);
+  for (int c = 0; c < 6; ++c)
+    std::printf(" %d", verb.lp_combs[c].L);
+  std::printf(" = multiples of %.2f, settled after %.1f ms  %s\n", period, 1000.0 * settled / rate,
+              tuned && reported ? "ok" : "FAIL");
+
+  verb.process(out.data(), nullptr, block);
+
+  bool restored = true;
+  for (int c = 0; c < 6; ++c)
+    restored = restored && verb.lp_combs[c].L == (int)std::round(own.L[c] * 0.001 * rate);
+
+  std::printf("  own delays back without a sidechain  %s\n", restored ? "ok" : "FAIL");
+
+  // cost of a block without a sidechain, ducking and pitch tuning
+  auto time = [&](const float* sidechainIn)
+  {
+    MoorerReverb t;
+    setupMoorer(t, rate);
+    t.setDucking(1.0);
+    t.setPitchTuning(1.0);
+
+    std::vector<float> buffer = noise;
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; ++b)
+      t.process(buffer.data() + (size_t)b * block, sidechainIn ? sidechainIn + (size_t)b * block : nullptr, block);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / blocks * 1e6;
+  };
+
+  std::printf("  us per %d sample block: no sidechain %.2f, ducking + pitch tuning %.2f\n", block, time(nullptr),
+              time(sine.data()));
+
+  return duckOk && tuned && reported && restored;
+}
+
+int main(int argc, char** argv)
+{
+  double seconds = 2.0, tailMinutes = 2.0;
+  bool tail = true;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc)
+      seconds = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--tail-minutes") && i + 1 < argc)
+      tailMinutes = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--no-tail"))
+      tail = false;
+    else
+    {
+      std::fprintf(stderr, "usage: %s [--seconds s] [--tail-minutes m] [--no-tail]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<Group> groups = makeGroups();
+  bool passed = true;
+
+  std::printf("%-14s %-20s %6s %12s %10s %8s  %s\n", "group", "variant", "rate", "max error", "SNR (dB)", "speedup", "result");
+
+  for (int rate : rates)
+  {
+    std::vector<Signal> corpus = makeCorpus(rate, seconds);
+
+    for (const Group& g : groups)
+    {
+      // reference output + time for every signal
+      std::vector<std::vector<float>> expected(corpus.size());
+      double referenceTime = 0.0;
+
+      for (size_t s = 0; s < corpus.size(); ++s)
+        referenceTime += timeKernel(g.reference, corpus[s].samples, expected[s], rate);
+
+      for (const Variant& v : g.variants)
+      {
+        double maxError = 0.0, signal = 0.0, noise = 0.0, time = 0.0;
+        std::vector<float> out;
+
+        for (size_t s = 0; s < corpus.size(); ++s)
+        {
+          time += timeKernel(v.run, corpus[s].samples, out, rate);
+
+          for (size_t i = 0; i < out.size(); ++i)
+          {
+            double e = (double)out[i] - expected[s][i];
+            maxError = std::fabs(e) > maxError ? std::fabs(e) : maxError;
+            signal += (double)expected[s][i] * expected[s][i];
+            noise += e * e;
+          }
+        }
+
+        bool ok = maxError <= v.tolerance;
+        passed = passed && ok;
+
+        char snr[32];
+        if (noise == 0.0)
+          std::snprintf(snr, sizeof(snr), "exact");
+        else
+          std::snprintf(snr, sizeof(snr), "%.1f", 10.0 * std::log10(signal / noise));
+
+        std::printf("%-14s %-20s %6d %12.3g %10s %7.2fx  %s\n", g.name, v.name, rate, maxError, snr,
+                    time > 0.0 ? referenceTime / time : 0.0, ok ? "ok" : "FAIL");
+      }
+    }
+  }
+
+  runFixedTail(seconds);
+
+  passed = runSubbands() && passed;
+  passed = runBank() && passed;
+  passed = runVelvet() && passed;
+  passed = runSidechain() && passed;
+
+  if (tail)
+    passed = runTail(tailMinutes) && passed;
+
+  std::printf("\n%s\n", passed ? "all variants within tolerance" : "some variants FAILED");
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file   ReferenceFilters.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Implementation of the reference filters (original algorithms,
+ *         don't optimize these, they define what "correct" sounds like)
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "ReferenceFilters.h"
+#include <cmath>
+
+namespace reference
+{
+
+/**
+ * @brief Refills the delay queues with L zeroes (L + 1 for x_(t-L-1))
+ *
+ * @param L_ delay (in samples)
+ */
+void LowPassComb::setDelay(int L_)
+{
+  isDirty = true;
+
+  L = L_;
+
+  std::queue<double> e1, e2, e3;
+  std::swap(delayX1, e1);
+  std::swap(delayX2, e2);
+  std::swap(delayY2, e3);
+
+  for (int i = 0; i < L; ++i)
+  {
+    delayX1.push(0.0f);
+    delayX2.push(0.0f);
+    delayY2.push(0.0f);
+  }
+
+  // one extra delay for (x_(t-L-1)
+  delayX2.push(0.0f);
+
+  if (isDirty)
+    isDirty = false;
+}
+
+/**
+ * @brief Lowpass-comb operator
+ *
+ *    yt = x_(t-L) - gx_(t-L-1) + gy_(t-1) + Ry_(t-L)
+ *
+ * @param x input
+ *
+ * @return float
+ */
+float LowPassComb::operator()(float x)
+{
+  double y = 0;
+
+  if (!isDirty)
+  {
+    if (!delayX1.empty() && !delayX2.empty() && !delayY2.empty())
+    {
+      // filter function
+      y = delayX1.front() - (g * delayX2.front())
+                 + (g * y1) + (R * delayY2.front());
+
+      // pop off front of queues
+      delayX1.pop();
+      delayX2.pop();
+      delayY2.pop();
+
+      // push new x/y into back of queues
+      delayX1.push((double)x);
+      delayX2.push((double)x);
+      delayY2.push(y);
+
+      // set single past y variable
+      y1 = y;
+    }
+  }
+
+  return y;
+}
+
+/**
+ * @brief Refills the delay queues with m zeroes
+ *
+ * @param m_ delay (in samples)
+ */
+void AllPass::setDelay(int m_)
+{
+  isDirty = true;
+
+  m = m_;
+
+  std::queue<double> e1, e2;
+  std::swap(delayX, e1);
+  std::swap(delayY, e2);
+
+  for (int i = 0; i < m; ++i)
+  {
+    delayX.push(0.0f);
+    delayY.push(0.0f);
+  }
+
+  if (isDirty)
+    isDirty = false;
+}
+
+/**
+ * @brief Allpass operator
+ *
+ *    yt = a*(x - y_(t-m)) + x_(t-m)
+ *
+ * @param x input
+ *
+ * @return float
+ */
+float AllPass::operator()(float x)
+{
+  double y = 0;
+
+  if (!isDirty)
+  {
+    if (!delayX.empty() && !delayY.empty())
+    {
+      y = a * ((double)x - delayY.front()) + delayX.front();
+
+      delayX.pop();
+      delayY.pop();
+
+      delayX.push((double)x);
+      delayY.push(y);
+    }
+  }
+
+  return y;
+}
+
+/**
+ * @brief Linear interpolation between two points
+ *
+ */
+static double lerpBetweenPlots(double x, double x1, double y1, double x2, double y2)
+{
+  return y1 + ((x - x1) / (x2 - x1)) * (y2 - y1);
+}
+
+/**
+ * @brief Moorer's suggested values, g interpolated between 25khz and 50khz
+ *
+ */
+void MoorerReverb::initializeFilters()
+{
+  const double lMs[6] = { 0.050, 0.056, 0.061, 0.068, 0.072, 0.078 };
+  const double g25[6] = { 0.24, 0.26, 0.28, 0.29, 0.30, 0.32 };
+  const double g50[6] = { 0.46, 0.48, 0.50, 0.52, 0.53, 0.55 };
+
+  for (int i = 0; i < numCombs; ++i)
+  {
+    lp_combs[i].setCoefficients(0.83, lerpBetweenPlots((double)rate, 25000.0, g25[i], 50000.0, g50[i]));
+    lp_combs[i].setDelay((int)std::round(lMs[i] * (double)rate));
+  }
+
+  // 6ms = .006 sec
+  ap.setCoefficient(0.7);
+  ap.setDelay((int)std::round(0.006 * (double)rate));
+}
+
+/**
+ * @brief Sum of all combs through the allpass, mixed with the clean signal
+ *
+ * @param x input
+ *
+ * @return float
+ */
+float MoorerReverb::operator()(float x)
+{
+  double y = 0.0f;
+
+  for (int i = 0; i < numCombs; i++)
+  {
+    // sum all comb filter outputs
+    y += lp_combs[i]((double)x);
+  }
+
+  // apply allpass, and add the clean value
+  return ((dry * x) + (wet * ap(y)));
+}
+
+}
@@ -0,0 +1,122 @@
+/**
+ * @file   ReferenceFilters.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Original (queue based) lowpass-comb, allpass and Moorer reverb,
+ *         kept untouched as the reference every optimized kernel is
+ *         measured against by the differential harness
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include "../Filters.h"
+#include <queue>
+
+namespace reference
+{
+
+/**
+ * @brief Lowpass-comb filter, straight from the transfer function with one
+ *        queue per delayed term
+ *
+ */
+class LowPassComb : public Filter
+{
+public:
+
+  // ctor
+  LowPassComb() : L(0), R(0.0), g(0.0), ratio(0.0), isDirty(false), y1(0.0) { }
+
+  void setCoefficients(double R_, double g_)
+  {
+    ratio = R_;
+    g = g_;
+    R = ratio - (ratio * g);
+  }
+
+  void setDelay(int L_);
+
+  float operator()(float x) override;
+
+  // delay value (in samples)
+  int L;
+
+  // dampening value + coefficient
+  double R, g, ratio;
+
+private:
+
+  bool isDirty;
+
+  // x/y delay queues
+  std::queue<double> delayX1, delayX2;
+  std::queue<double> delayY2;
+
+  double y1;
+};
+
+/**
+ * @brief Allpass filter, one queue each for past x and y
+ *
+ */
+class AllPass : public Filter
+{
+public:
+
+  // ctor
+  AllPass() : isDirty(false), m(0), a(0.0) { }
+
+  void setCoefficient(double a_) { a = a_; }
+
+  void setDelay(int m_);
+
+  float operator()(float x) override;
+
+  bool isDirty;
+
+private:
+
+  // delay value (in samples)
+  int m;
+
+  // coeff
+  double a;
+
+  // x/y delay queues
+  std::queue<double> delayX;
+  std::queue<double> delayY;
+};
+
+/**
+ * @brief Moorer reverb, six lowpass-combs into a single allpass
+ *
+ */
+class MoorerReverb : public Filter
+{
+public:
+
+  MoorerReverb(int samplingRate, double mix_) : rate(samplingRate), wet(mix_), dry(1.0 - mix_) { initializeFilters(); }
+
+  void initializeFilters();
+
+  float operator()(float x) override;
+
+  // filter objects (public to allow access to setters)
+  LowPassComb lp_combs[6];
+  AllPass ap;
+
+  // sampling rate
+  int rate;
+
+private:
+
+  // number of comb filters needed
+  const int numCombs = 6;
+
+  // our wet/dry values
+  double wet, dry;
+};
+
+}
@@ -0,0 +1,569 @@
+/**
+ * @file   ReverbMetrics.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Acoustic metrics for reverb parameter sweeps. Renders a MoorerReverb
+ *         impulse response per parameter set (a grid around Moorer's
+ *         defaults, or random sets) on every core and writes one CSV row
+ *         per set: RT60/EDT from Schroeder backward integration, the
+ *         normalized echo density profile, RT60 per octave band and the
+ *         stability margin of the comb loops.
+ *
+ *         g++ -std=c++17 -O2 -pthread -I.. ReverbMetrics.cpp ../DelayArena.cpp ../Filters.cpp
+ *             ../Followers.cpp ../MoorerReverb.cpp ../Subbands.cpp -o reverbmetrics
+ *         ./reverbmetrics [--grid 5 | --random 1000] [--seed 1] [--rate 48000] [--seconds 4]
+ *                         [--stages 4] [--threads 0] [--target 1.5 --tolerance 0.1] [--out file.csv]
+ *
+ *         With --target, also prints (to stderr) the cheapest sets whose
+ *         RT60 is within tolerance of the target, fewest combs first.
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "../MoorerReverb.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+// octave band centres the decay is measured at (bands above 0.45 of the
+// rate are skipped)
+static const double octaveCentres[] = { 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0 };
+static const int numOctaves = (int)(sizeof(octaveCentres) / sizeof(octaveCentres[0]));
+
+// times (ms) the echo density profile is reported at, and its window
+static const double densityTimes[] = { 20.0, 50.0, 100.0, 200.0, 500.0 };
+static const int numDensityTimes = (int)(sizeof(densityTimes) / sizeof(densityTimes[0]));
+static const double densityWindowMs = 20.0;
+
+// grid axes, comb ratio, scale on Moorer's g and L, and comb counts
+static const double ratioRange[2] = { 0.70, 0.95 };
+static const double gScaleRange[2] = { 0.5, 1.5 };
+static const double lScaleRange[2] = { 0.6, 1.4 };
+
+// random sets, per comb ranges
+static const double gRange[2] = { 0.1, 0.7 };
+static const double lRange[2] = { 20.0, 100.0 };
+
+/**
+ * @brief One point of the sweep, the comb settings the reverb runs with
+ *
+ */
+struct SweepSet
+{
+  int combs;
+  MoorerParameters p;
+};
+
+/**
+ * @brief Everything measured from one impulse response (NAN where the
+ *        response didn't decay far enough to measure)
+ *
+ */
+struct Metrics
+{
+  double rt60, edt;
+  double density[numDensityTimes];
+  double mixingMs;
+  double octaveRt60[numOctaves];
+  double margin;
+};
+
+/**
+ * @brief Grid around the defaults, every combination of ratio, g scale and
+ *        L scale (steps per axis) for 1 - 6 combs
+ *
+ */
+static std::vector<SweepSet> makeGrid(const MoorerParameters& base, int steps)
+{
+  std::vector<SweepSet> sets;
+
+  auto axis = [steps](const double* range, int i)
+  {
+    return steps > 1 ? range[0] + (range[1] - range[0]) * i / (steps - 1) : 0.5 * (range[0] + range[1]);
+  };
+
+  for (int combs = 1; combs <= 6; ++combs)
+    for (int r = 0; r < steps; ++r)
+      for (int g = 0; g < steps; ++g)
+        for (int l = 0; l < steps; ++l)
+        {
+          SweepSet s = { combs, base };
+
+          for (int c = 0; c < 6; ++c)
+          {
+            s.p.ratio[c] = axis(ratioRange, r);
+            s.p.g[c] = std::min(base.g[c] * axis(gScaleRange, g), 0.95);
+            s.p.L[c] = std::min(base.L[c] * axis(lScaleRange, l), MoorerReverb::maxDelaySeconds * 1000.0);
+          }
+
+          sets.push_back(s);
+        }
+
+  return sets;
+}
+
+/**
+ * @brief Random sets, every comb's ratio, g and L drawn on its own (sorted
+ *        so L rises with the comb index like Moorer's), seeded per set so
+ *        a set doesn't depend on how many were asked for
+ *
+ */
+static std::vector<SweepSet> makeRandom(const MoorerParameters& base, int count, unsigned seed)
+{
+  std::vector<SweepSet> sets;
+
+  for (int i = 0; i < count; ++i)
+  {
+    std::mt19937 rng(seed * 1000003u + (unsigned)i);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto draw = [&](const double* range) { return range[0] + (range[1] - range[0]) * unit(rng); };
+
+    SweepSet s = { 1 + (int)(unit(rng) * 6.0) % 6, base };
+
+    for (int c = 0; c < 6; ++c)
+    {
+      s.p.ratio[c] = draw(ratioRange);
+      s.p.g[c] = draw(gRange);
+      s.p.L[c] = draw(lRange);
+    }
+
+    std::sort(s.p.L, s.p.L + 6);
+    sets.push_back(s);
+  }
+
+  return sets;
+}
+
+/**
+ * @brief Renders a set's impulse response, wet only. Quality is set first
+ *        and its fade run out over silence so the impulse sees the final
+ *        comb gains.
+ *
+ */
+static void render(const SweepSet& s, int rate, int stages, std::vector<float>& ir)
+{
+  MoorerReverb verb;
+  verb.setRate(rate);
+  verb.initializeFilters();
+
+  MoorerParameters p = s.p;
+  p.mix = 1.0;
+  p.stages = stages;
+  verb.applyParameters(p);
+  verb.setQuality(s.combs, stages);
+
+  std::vector<float> silence(rate / 50, 0.0f);
+  verb.process(silence.data(), (int)silence.size());
+
+  std::fill(ir.begin(), ir.end(), 0.0f);
+  ir[0] = 1.0f;
+  verb.process(ir.data(), (int)ir.size());
+}
+
+/**
+ * @brief Schroeder backward integration, energy decay curve in dB (0 at
+ *        the start)
+ *
+ */
+static void decayCurve(const float* h, int n, std::vector<double>& edc)
+{
+  edc.resize(n);
+
+  double sum = 0.0;
+  for (int i = n - 1; i >= 0; --i)
+  {
+    sum += (double)h[i] * h[i];
+    edc[i] = sum;
+  }
+
+  double scale = sum > 0.0 ? 1.0 / sum : 0.0;
+  for (int i = 0; i < n; ++i)
+    edc[i] = 10.0 * std::log10(edc[i] * scale + 1e-300);
+}
+
+/**
+ * @brief Decay time (seconds to fall 60dB) from a least squares line through
+ *        the curve between two levels, NAN if the curve never reaches the
+ *        lower one
+ *
+ * @param edc   energy decay curve (dB)
+ * @param upper level the fit starts at (e.g. -5)
+ * @param lower level the fit ends at (e.g. -35)
+ */
+static double decayTime(const std::vector<double>& edc, double upper, double lower, int rate)
+{
+  const int n = (int)edc.size();
+
+  int start = 0;
+  while (start < n && edc[start] > upper)
+    ++start;
+
+  int end = start;
+  while (end < n && edc[end] > lower)
+    ++end;
+
+  if (end >= n || end - start < 2)
+    return NAN;
+
+  // sums of the line fit, four accumulators each so the loop vectorizes
+  double st[4] = { }, sy[4] = { }, sty[4] = { }, stt[4] = { };
+  const double* y = edc.data() + start;
+  const int count = end - start;
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+    for (int l = 0; l < 4; ++l)
+    {
+      double t = (double)(i + l);
+      st[l] += t;
+      sy[l] += y[i + l];
+      sty[l] += t * y[i + l];
+      stt[l] += t * t;
+    }
+
+  for (; i < count; ++i)
+  {
+    st[0] += i;
+    sy[0] += y[i];
+    sty[0] += i * y[i];
+    stt[0] += (double)i * i;
+  }
+
+  double sumT = st[0] + st[1] + st[2] + st[3];
+  double sumY = sy[0] + sy[1] + sy[2] + sy[3];
+  double sumTY = sty[0] + sty[1] + sty[2] + sty[3];
+  double sumTT = stt[0] + stt[1] + stt[2] + stt[3];
+
+  double slope = (count * sumTY - sumT * sumY) / (count * sumTT - sumT * sumT);
+
+  return slope < 0.0 ? -60.0 / slope / rate : NAN;
+}
+
+/**
+ * @brief Normalized echo density (Abel & Huang), the fraction of a window's
+ *        samples above its standard deviation over the fraction a gaussian
+ *        has there (erfc(1 / sqrt(2))). 1 is noise-like, a sparse early
+ *        response sits well below.
+ *
+ * @param centre sample the window is centred on
+ */
+static double echoDensity(const float* h, int n, int centre, int window)
+{
+  int start = std::max(0, centre - window / 2);
+  int end = std::min(n, start + window);
+  int count = end - start;
+
+  if (count <= 0)
+    return NAN;
+
+  float energy = 0.0f;
+  for (int i = start; i < end; ++i)
+    energy += h[i] * h[i];
+
+  float sigma = std::sqrt(energy / count);
+  if (sigma == 0.0f)
+    return 0.0;
+
+  int above = 0;
+  for (int i = start; i < end; ++i)
+    above += std::fabs(h[i]) > sigma;
+
+  return (double)above / count / std::erfc(1.0 / std::sqrt(2.0));
+}
+
+/**
+ * @brief Splits the response into octave bands in one pass, one RBJ band
+ *        pass (one octave wide) per lane so the band loop vectorizes
+ *
+ * @param bands numOctaves responses out (bands past the rate are zero)
+ */
+static void octaveBands(const float* h, int n, int rate, std::vector<float> bands[numOctaves])
+{
+  double b0[numOctaves] = { }, b2[numOctaves] = { }, a1[numOctaves] = { }, a2[numOctaves] = { };
+  double x1[numOctaves] = { }, x2[numOctaves] = { }, y1[numOctaves] = { }, y2[numOctaves] = { };
+
+  for (int b = 0; b < numOctaves; ++b)
+  {
+    bands[b].assign(n, 0.0f);
+
+    if (octaveCentres[b] >= 0.45 * rate)
+      continue;
+
+    const double w = 2.0 * M_PI * octaveCentres[b] / rate;
+    const double alpha = std::sin(w) * std::sinh(std::log(2.0) / 2.0 * w / std::sin(w));
+    const double a0 = 1.0 + alpha;
+
+    b0[b] = alpha / a0;
+    b2[b] = -alpha / a0;
+    a1[b] = -2.0 * std::cos(w) / a0;
+    a2[b] = (1.0 - alpha) / a0;
+  }
+
+  for (int i = 0; i < n; ++i)
+  {
+    const double x = h[i];
+    double y[numOctaves];
+
+    for (int b = 0; b < numOctaves; ++b)
+    {
+      y[b] = b0[b] * x + b2[b] * x2[b] - a1[b] * y1[b] - a2[b] * y2[b];
+      x2[b] = x1[b];
+      x1[b] = x;
+      y2[b] = y1[b];
+      y1[b] = y[b];
+    }
+
+    for (int b = 0; b < numOctaves; ++b)
+      bands[b][i] = (float)y[b];
+  }
+}
+
+/**
+ * @brief Stability margin, 1 minus the largest loop gain of any running
+ *        comb. A comb's loop R / (1 - g z^-1) peaks at R / (1 - |g|) (DC
+ *        for positive g), the diffuser is allpass and adds nothing.
+ *
+ */
+static double stabilityMargin(const SweepSet& s)
+{
+  double peak = 0.0;
+
+  for (int c = 0; c < s.combs; ++c)
+  {
+    double g = s.p.g[c];
+    double R = s.p.ratio[c] * (1.0 - g);
+    peak = std::max(peak, std::fabs(R) / (1.0 - std::fabs(g)));
+  }
+
+  return 1.0 - peak;
+}
+
+/**
+ * @brief Renders and measures one set
+ *
+ */
+static Metrics measure(const SweepSet& s, int rate, int stages, std::vector<float>& ir,
+                       std::vector<double>& edc, std::vector<float> bands[numOctaves])
+{
+  Metrics m;
+  const int n = (int)ir.size();
+
+  render(s, rate, stages, ir);
+
+  decayCurve(ir.data(), n, edc);
+  m.rt60 = decayTime(edc, -5.0, -35.0, rate);
+  if (std::isnan(m.rt60))
+    m.rt60 = decayTime(edc, -5.0, -25.0, rate);
+  m.edt = decayTime(edc, 0.0, -10.0, rate);
+
+  const int window = (int)std::round(densityWindowMs * 0.001 * rate);
+  for (int t = 0; t < numDensityTimes; ++t)
+    m.density[t] = echoDensity(ir.data(), n, (int)std::round(densityTimes[t] * 0.001 * rate), window);
+
+  // mixing time, first 1ms step whose echo density reaches 1
+  m.mixingMs = NAN;
+  const int hop = std::max(1, rate / 1000);
+  for (int centre = window / 2; centre < n - window / 2; centre += hop)
+    if (echoDensity(ir.data(), n, centre, window) >= 1.0)
+    {
+      m.mixingMs = centre * 1000.0 / rate;
+      break;
+    }
+
+  octaveBands(ir.data(), n, rate, bands);
+  for (int b = 0; b < numOctaves; ++b)
+  {
+    m.octaveRt60[b] = NAN;
+
+    if (octaveCentres[b] >= 0.45 * rate)
+      continue;
+
+    decayCurve(bands[b].data(), n, edc);
+    m.octaveRt60[b] = decayTime(edc, -5.0, -35.0, rate);
+    if (std::isnan(m.octaveRt60[b]))
+      m.octaveRt60[b] = decayTime(edc, -5.0, -25.0, rate);
+  }
+
+  m.margin = stabilityMargin(s);
+
+  return m;
+}
+
+// prints a value, empty if it couldn't be measured
+static void printValue(FILE* f, double v)
+{
+  if (std::isnan(v))
+    std::fprintf(f, ",");
+  else
+    std::fprintf(f, ",%.4f", v);
+}
+
+static void writeCsv(FILE* f, const std::vector<SweepSet>& sets, const std::vector<Metrics>& metrics)
+{
+  std::fprintf(f, "id,combs");
+  for (const char* name : { "ratio", "g", "L" })
+    for (int c = 0; c < 6; ++c)
+      std::fprintf(f, ",%s%d", name, c);
+  std::fprintf(f, ",rt60,edt");
+  for (double t : densityTimes)
+    std::fprintf(f, ",ned_%gms", t);
+  std::fprintf(f, ",mixing_ms");
+  for (double c : octaveCentres)
+    std::fprintf(f, ",rt60_%ghz", c);
+  std::fprintf(f, ",margin\n");
+
+  for (size_t i = 0; i < sets.size(); ++i)
+  {
+    const SweepSet& s = sets[i];
+    const Metrics& m = metrics[i];
+
+    std::fprintf(f, "%zu,%d", i, s.combs);
+    for (int c = 0; c < 6; ++c)
+      std::fprintf(f, ",%.4f", s.p.ratio[c]);
+    for (int c = 0; c < 6; ++c)
+      std::fprintf(f, ",%.4f", s.p.g[c]);
+    for (int c = 0; c < 6; ++c)
+      std::fprintf(f, ",%.2f", s.p.L[c]);
+
+    printValue(f, m.rt60);
+    printValue(f, m.edt);
+    for (double d : m.density)
+      printValue(f, d);
+    printValue(f, m.mixingMs);
+    for (double r : m.octaveRt60)
+      printValue(f, r);
+    printValue(f, m.margin);
+    std::fprintf(f, "\n");
+  }
+}
+
+/**
+ * @brief Lists the sets that hit the target decay, fewest combs first
+ *        (then densest echo at 100ms), so presets can be picked for cost
+ *
+ */
+static void reportTarget(const std::vector<SweepSet>& sets, const std::vector<Metrics>& metrics,
+                         double target, double tolerance)
+{
+  std::vector<size_t> hits;
+
+  for (size_t i = 0; i < sets.size(); ++i)
+    if (!std::isnan(metrics[i].rt60) && std::fabs(metrics[i].rt60 - target) <= tolerance && metrics[i].margin > 0.0)
+      hits.push_back(i);
+
+  std::sort(hits.begin(), hits.end(), [&](size_t a, size_t b)
+  {
+    if (sets[a].combs != sets[b].combs)
+      return sets[a].combs < sets[b].combs;
+    return metrics[a].density[2] > metrics[b].density[2];
+  });
+
+  std::fprintf(stderr, "\n%zu of %zu sets within %.2fs of rt60 %.2fs\n", hits.size(), sets.size(), tolerance, target);
+  std::fprintf(stderr, "  %6s %6s %8s %8s %10s %8s\n", "id", "combs", "rt60", "edt", "ned@100ms", "margin");
+
+  for (size_t k = 0; k < hits.size() && k < 10; ++k)
+  {
+    const Metrics& m = metrics[hits[k]];
+    std::fprintf(stderr, "  %6zu %6d %8.3f %8.3f %10.3f %8.3f\n", hits[k], sets[hits[k]].combs, m.rt60, m.edt, m.density[2], m.margin);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int grid = 0, random = 0, rate = 48000, stages = 4, threads = 0;
+  unsigned seed = 1;
+  double seconds = 4.0, target = 0.0, tolerance = 0.1;
+  const char* outPath = nullptr;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!std::strcmp(argv[i], "--grid") && i + 1 < argc)
+      grid = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--random") && i + 1 < argc)
+      random = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+      seed = (unsigned)std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--rate") && i + 1 < argc)
+      rate = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc)
+      seconds = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--stages") && i + 1 < argc)
+      stages = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+      threads = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--target") && i + 1 < argc)
+      target = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc)
+      tolerance = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--out") && i + 1 < argc)
+      outPath = argv[++i];
+    else
+    {
+      std::fprintf(stderr, "usage: %s [--grid steps | --random count] [--seed n] [--rate hz] [--seconds s]\n"
+                           "       [--stages n] [--threads n] [--target s] [--tolerance s] [--out file.csv]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (rate < 8000 || seconds <= 0.0)
+  {
+    std::fprintf(stderr, "rate must be at least 8000 and seconds positive\n");
+    return 2;
+  }
+
+  // Moorer's defaults at this rate are the grid's centre
+  MoorerReverb defaults;
+  defaults.setRate(rate);
+  defaults.initializeFilters();
+  MoorerParameters base = defaults.getParameters();
+
+  std::vector<SweepSet> sets = random > 0 ? makeRandom(base, random, seed) : makeGrid(base, grid > 0 ? grid : 5);
+
+  if (threads <= 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::fprintf(stderr, "%zu sets, %.1fs at %dhz, %d threads\n", sets.size(), seconds, rate, threads);
+
+  // workers claim sets one at a time, each keeps its own buffers
+  std::vector<Metrics> metrics(sets.size());
+  std::atomic<size_t> next(0);
+  const int n = (int)(seconds * rate);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&]()
+    {
+      std::vector<float> ir(n);
+      std::vector<double> edc;
+      std::vector<float> bands[numOctaves];
+
+      for (size_t i = next++; i < sets.size(); i = next++)
+        metrics[i] = measure(sets[i], rate, stages, ir, edc, bands);
+    });
+
+  for (std::thread& w : workers)
+    w.join();
+
+  FILE* f = outPath ? std::fopen(outPath, "w") : stdout;
+  if (!f)
+  {
+    std::fprintf(stderr, "can't open %s\n", outPath);
+    return 1;
+  }
+
+  writeCsv(f, sets, metrics);
+
+  if (f != stdout)
+    std::fclose(f);
+
+  if (target > 0.0)
+    reportTarget(sets, metrics, target, tolerance);
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file   FeedbackDelay.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Feedback delay shared by the delay externals, same signal flow
+ *         as delay_audio.pd but done in one pass
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include "../../juce/Filters.h"
+#include "../../juce/LongDelay.h"
+#include "../../juce/Denormals.h"
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Feedback delay with optional random delay time modulation
+ * 
+ *   X                                                  Y
+ *  ---> [SUM] ---> | z^-D | ---> *delay gain ---> [SUM] --->
+ *   |     |                          |              |
+ *   |     <-------- *feedback <------|              |
+ *   |                                               |
+ *   --------------------- *clean ------------------>|
+ *
+ *   D = delay time + random(0, depth) picked rate times a second, smoothed
+ *
+ *        Line is the delay line type, DelayLine for regular delays or
+ *        LongDelayLine for multi minute ones.
+ * 
+ */
+template <class Line = DelayLine>
+class FeedbackDelay
+{
+public:
+
+  // ctor
+  FeedbackDelay() : sr(44100.0), maxMs(0.0), clean(1.0), timeMs(0.0), feedback(0.0), gain(0.0),
+                    depthMs(0.0), modRate(0.0), modOffset(0.0), modCounter(0), d(-1.0), smooth(1.0), seed(1) { }
+
+  // (re)sizes the delay line for delays up to maxMs_ at sampleRate,
+  // only reallocates if the line needs to grow
+  void prepare(double sampleRate, double maxMs_)
+  {
+    sr = sampleRate;
+    maxMs = maxMs_;
+
+    // two extra samples for interpolation
+    line.reserve((int)std::ceil(maxMs * 0.001 * sr) + 2);
+
+    // ~20ms to glide to a new delay time
+    smooth = 1.0 - std::exp(-1.0 / (0.02 * sr));
+
+    // jump straight to the first delay time we see
+    d = -1.0;
+  }
+
+  void setClean(double v) { clean = v; }
+  void setTime(double ms) { timeMs = ms; }
+  void setFeedback(double v) { feedback = v; }
+  void setGain(double v) { gain = v; }
+
+  // modulation depth (ms) and how many new random offsets per second
+  void setModDepth(double ms) { depthMs = ms; }
+  void setModRate(double hz) { modRate = hz; }
+
+  // processes a block, in and out may point to the same memory
+  void process(const float* in, float* out, int n)
+  {
+    const double maxD = line.getCapacity() - 2;
+    const double toSamples = 0.001 * sr;
+
+    // feedback tails decay toward denormals during silence
+    ScopedFlushToZero ftz;
+
+    for (int i = 0; i < n; ++i)
+    {
+      // pick a new random offset when the modulation period runs out
+      if (depthMs > 0.0 && modRate > 0.0 && --modCounter <= 0)
+      {
+        modCounter = (int)(sr / modRate);
+        modOffset = depthMs * random01();
+      }
+      else if (depthMs <= 0.0)
+        modOffset = 0.0;
+
+      double target = (timeMs + modOffset) * toSamples;
+      target = target < 1.0 ? 1.0 : (target > maxD ? maxD : target);
+      d = d < 0.0 ? target : d + smooth * (target - d);
+
+      double x = in[i];
+      double delayed = gain * line.readLinear(d);
+
+      line.write(x + feedback * delayed);
+      out[i] = (float)(clean * x + delayed);
+    }
+  }
+
+private:
+
+  // uniform random value in [0, 1)
+  double random01()
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) * (1.0 / 16777216.0);
+  }
+
+  Line line;
+
+  double sr, maxMs;
+
+  // gains + delay time (ms)
+  double clean, timeMs, feedback, gain;
+
+  // modulation depth (ms), rate (hz), current random offset (ms)
+  double depthMs, modRate, modOffset;
+  int modCounter;
+
+  // current (smoothed) delay in samples, and smoothing coefficient
+  double d, smooth;
+
+  uint32_t seed;
+};
@@ -0,0 +1,194 @@
+/**
+ * @file   OscillatorBank.h
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Additive oscillator bank used by oscbank~ to resynthesize
+ *         sigmund~ peaks
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+
+/**
+ * @brief Bank of N sinusoids, each a recursive rotator
+ *
+ *   [c]    [cos(w)  -sin(w)] [c]
+ *   [s] =  [sin(w)   cos(w)] [s]      y = sum(amp * s)
+ *
+ *        Partials are stored as structure of arrays, and the kernel runs
+ *        lanes partials side by side so every step of the rotation (and the
+ *        amplitude ramp) is one vector op across a group of partials.
+ *        Frequency and amplitude glide towards their targets once per block.
+ * 
+ */
+class OscillatorBank
+{
+public:
+
+  // partials processed side by side in the kernel
+  static const int lanes = 8;
+
+  // ctor
+  OscillatorBank() : numPartials(0), sr(44100.0), scale(1.0), freqSmooth(1.0), ampSmooth(1.0) { }
+
+  // allocates room for n partials (rounded up to a multiple of lanes)
+  void setNumPartials(int n)
+  {
+    numPartials = n < 1 ? 1 : n;
+    int padded = (numPartials + lanes - 1) / lanes * lanes;
+
+    c.assign(padded, 1.0f);
+    s.assign(padded, 0.0f);
+    cosw.assign(padded, 1.0f);
+    sinw.assign(padded, 0.0f);
+    amp.assign(padded, 0.0f);
+    ampStep.assign(padded, 0.0f);
+    freq.assign(padded, 0.0f);
+    targetFreq.assign(padded, 0.0f);
+    targetAmp.assign(padded, 0.0f);
+  }
+
+  int getNumPartials() const { return numPartials; }
+
+  // sets rate, and how quickly (in seconds) partials glide to new values
+  void prepare(double sampleRate, int blockSize, double glideSeconds)
+  {
+    sr = sampleRate;
+
+    double blocksPerGlide = glideSeconds * sr / blockSize;
+    freqSmooth = blocksPerGlide > 1.0 ? (float)(1.0 - std::exp(-1.0 / blocksPerGlide)) : 1.0f;
+    ampSmooth = freqSmooth;
+  }
+
+  // sets a partial's target frequency (hz) and amplitude
+  void setPartial(int index, float f, float a)
+  {
+    if (index < 0 || index >= numPartials)
+      return;
+
+    // a partial that was silent starts right at its new frequency
+    if (targetAmp[index] == 0.0f && amp[index] == 0.0f)
+      freq[index] = f;
+
+    targetFreq[index] = f;
+    targetAmp[index] = a;
+  }
+
+  // fades every partial out
+  void clear()
+  {
+    for (int k = 0; k < numPartials; ++k)
+      targetAmp[k] = 0.0f;
+  }
+
+  // multiplies every partial's frequency (transposition)
+  void setScale(float scale_) { scale = scale_; }
+
+  // renders n samples of the summed partials into out
+  void process(float* out, int n)
+  {
+    const int padded = (int)c.size();
+
+    updateBlock(n);
+
+    for (int i = 0; i < n; ++i)
+      out[i] = 0.0f;
+
+    for (int k = 0; k < padded; k += lanes)
+    {
+      // skip groups where every partial is silent
+      bool silent = true;
+      for (int j = 0; j < lanes; ++j)
+        silent = silent && amp[k + j] == 0.0f && ampStep[k + j] == 0.0f;
+      if (silent)
+        continue;
+
+      float lc[lanes], ls[lanes], lcw[lanes], lsw[lanes], la[lanes], lda[lanes];
+
+      for (int j = 0; j < lanes; ++j)
+      {
+        lc[j] = c[k + j];  ls[j] = s[k + j];
+        lcw[j] = cosw[k + j];  lsw[j] = sinw[k + j];
+        la[j] = amp[k + j];  lda[j] = ampStep[k + j];
+      }
+
+      for (int i = 0; i < n; ++i)
+      {
+        float acc[lanes];
+
+        for (int j = 0; j < lanes; ++j)
+        {
+          float nc = lc[j] * lcw[j] - ls[j] * lsw[j];
+          float ns = lc[j] * lsw[j] + ls[j] * lcw[j];
+          lc[j] = nc;
+          ls[j] = ns;
+          la[j] += lda[j];
+          acc[j] = la[j] * ns;
+        }
+
+        float sum = 0.0f;
+        for (int j = 0; j < lanes; ++j)
+          sum += acc[j];
+
+        out[i] += sum;
+      }
+
+      for (int j = 0; j < lanes; ++j)
+      {
+        // pull rotators back onto the unit circle so rounding can't build up
+        float g = 1.5f - 0.5f * (lc[j] * lc[j] + ls[j] * ls[j]);
+
+        c[k + j] = lc[j] * g;
+        s[k + j] = ls[j] * g;
+        amp[k + j] = la[j];
+        ampStep[k + j] = 0.0f;
+      }
+    }
+  }
+
+private:
+
+  // glides frequency/amplitude for the coming block, recomputes rotations
+  void updateBlock(int n)
+  {
+    const float nyquist = (float)(sr * 0.5);
+    const float toRadians = (float)(2.0 * 3.14159265358979323846 / sr);
+
+    for (int k = 0; k < numPartials; ++k)
+    {
+      freq[k] += freqSmooth * (targetFreq[k] - freq[k]);
+
+      float f = freq[k] * scale;
+      float a = amp[k] + ampSmooth * (targetAmp[k] - amp[k]);
+
+      // partials above nyquist are faded out
+      if (f >= nyquist || f <= 0.0f)
+        a = 0.0f;
+
+      // snap tiny amplitudes to zero so silent groups get skipped
+      if (std::fabs(a) < 1e-6f)
+        a = 0.0f;
+
+      ampStep[k] = (a - amp[k]) / n;
+      cosw[k] = std::cos(f * toRadians);
+      sinw[k] = std::sin(f * toRadians);
+    }
+  }
+
+  int numPartials;
+  double sr;
+  float scale, freqSmooth, ampSmooth;
+
+  // rotator state and per sample rotation
+  std::vector<float> c, s, cosw, sinw;
+
+  // current amplitude and its per sample ramp for this block
+  std::vector<float> amp, ampStep;
+
+  // current and target frequency (hz), target amplitude
+  std::vector<float> freq, targetFreq, targetAmp;
+};
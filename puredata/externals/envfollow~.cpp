@@ -0,0 +1,109 @@
+/**
+ * @file   envfollow~.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Pd external, audio rate envelope follower replacing the
+ *         env~ -> dbtorms~ -> metro/snapshot~ polling in envelope_follower.pd
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "m_pd.h"
+#include "../../juce/Followers.h"
+
+static t_class* envfollow_tilde_class;
+
+/**
+ * @brief Object struct
+ * 
+ */
+struct t_envfollow_tilde
+{
+  t_object x_obj;
+  t_float x_f;
+
+  EnvelopeFollower* follower;
+
+  t_outlet* x_out;
+};
+
+static t_int* envfollow_tilde_perform(t_int* w)
+{
+  t_envfollow_tilde* x = (t_envfollow_tilde*)(w[1]);
+  t_sample* in = (t_sample*)(w[2]);
+  t_sample* out = (t_sample*)(w[3]);
+  int n = (int)(w[4]);
+
+  x->follower->process(in, out, n);
+
+  return (w + 5);
+}
+
+static void envfollow_tilde_dsp(t_envfollow_tilde* x, t_signal** sp)
+{
+  x->follower->setRate(sp[0]->s_sr);
+
+  dsp_add(envfollow_tilde_perform, 4, x, sp[0]->s_vec, sp[1]->s_vec, (t_int)sp[0]->s_n);
+}
+
+/**
+ * @brief [attack ms( / [release ms( / [peak( / [rms(
+ * 
+ */
+static void envfollow_tilde_attack(t_envfollow_tilde* x, t_floatarg f)
+{
+  x->follower->setAttack(f);
+}
+
+static void envfollow_tilde_release(t_envfollow_tilde* x, t_floatarg f)
+{
+  x->follower->setRelease(f);
+}
+
+static void envfollow_tilde_peak(t_envfollow_tilde* x)
+{
+  x->follower->setMode(EnvelopeFollower::Peak);
+}
+
+static void envfollow_tilde_rms(t_envfollow_tilde* x)
+{
+  x->follower->setMode(EnvelopeFollower::RMS);
+}
+
+/**
+ * @brief [envfollow~ <attack ms> <release ms>], RMS like env~ by default
+ * 
+ */
+static void* envfollow_tilde_new(t_floatarg attack, t_floatarg release)
+{
+  t_envfollow_tilde* x = (t_envfollow_tilde*)pd_new(envfollow_tilde_class);
+
+  x->follower = new EnvelopeFollower();
+  x->follower->setMode(EnvelopeFollower::RMS);
+  x->follower->setAttack(attack > 0 ? attack : 10);
+  x->follower->setRelease(release > 0 ? release : 100);
+
+  x->x_out = outlet_new(&x->x_obj, &s_signal);
+
+  return (void*)x;
+}
+
+static void envfollow_tilde_free(t_envfollow_tilde* x)
+{
+  delete x->follower;
+}
+
+extern "C" void envfollow_tilde_setup(void)
+{
+  envfollow_tilde_class = class_new(gensym("envfollow~"), (t_newmethod)envfollow_tilde_new,
+                                    (t_method)envfollow_tilde_free, sizeof(t_envfollow_tilde),
+                                    CLASS_DEFAULT, A_DEFFLOAT, A_DEFFLOAT, 0);
+
+  CLASS_MAINSIGNALIN(envfollow_tilde_class, t_envfollow_tilde, x_f);
+
+  class_addmethod(envfollow_tilde_class, (t_method)envfollow_tilde_dsp, gensym("dsp"), A_CANT, 0);
+  class_addmethod(envfollow_tilde_class, (t_method)envfollow_tilde_attack, gensym("attack"), A_FLOAT, 0);
+  class_addmethod(envfollow_tilde_class, (t_method)envfollow_tilde_release, gensym("release"), A_FLOAT, 0);
+  class_addmethod(envfollow_tilde_class, (t_method)envfollow_tilde_peak, gensym("peak"), A_NULL);
+  class_addmethod(envfollow_tilde_class, (t_method)envfollow_tilde_rms, gensym("rms"), A_NULL);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file   longdelay~.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Pd external, long feedback delay replacing delay_audio_long.pd
+ *         with a single object, history past the first ~1.4s is kept as
+ *         16 bit chunks so delays of minutes stay small in memory
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "m_pd.h"
+#include "FeedbackDelay.h"
+
+static t_class* longdelay_tilde_class;
+
+/**
+ * @brief Object struct, inlets match delay_audio_long.pd
+ *        (signal, clean gain, delay time, feedback, delay gain)
+ * 
+ */
+struct t_longdelay_tilde
+{
+  t_object x_obj;
+  t_float x_f;
+
+  // control inlet values
+  t_float clean, time, feedback, gain;
+
+  // largest delay time (ms), set by creation argument
+  t_float maxMs;
+
+  FeedbackDelay<LongDelayLine>* delay;
+
+  t_outlet* x_out;
+};
+
+/**
+ * @brief Perform routine, whole feedback loop in one pass
+ * 
+ */
+static t_int* longdelay_tilde_perform(t_int* w)
+{
+  t_longdelay_tilde* x = (t_longdelay_tilde*)(w[1]);
+  t_sample* in = (t_sample*)(w[2]);
+  t_sample* out = (t_sample*)(w[3]);
+  int n = (int)(w[4]);
+
+  x->delay->setClean(x->clean);
+  x->delay->setTime(x->time);
+  x->delay->setFeedback(x->feedback);
+  x->delay->setGain(x->gain);
+
+  x->delay->process(in, out, n);
+
+  return (w + 5);
+}
+
+/**
+ * @brief Sizes the delay line for the current rate (only place memory is allocated)
+ * 
+ */
+static void longdelay_tilde_dsp(t_longdelay_tilde* x, t_signal** sp)
+{
+  x->delay->prepare(sp[0]->s_sr, x->maxMs);
+
+  dsp_add(longdelay_tilde_perform, 4, x, sp[0]->s_vec, sp[1]->s_vec, (t_int)sp[0]->s_n);
+}
+
+/**
+ * @brief [longdelay~ <max ms>], defaults to delay_audio_long's 23000ms
+ * 
+ */
+static void* longdelay_tilde_new(t_floatarg maxMs)
+{
+  t_longdelay_tilde* x = (t_longdelay_tilde*)pd_new(longdelay_tilde_class);
+
+  x->maxMs = maxMs > 0 ? maxMs : 23000;
+  x->clean = 1;
+  x->time = 0;
+  x->feedback = 0;
+  x->gain = 0;
+
+  x->delay = new FeedbackDelay<LongDelayLine>();
+
+  floatinlet_new(&x->x_obj, &x->clean);
+  floatinlet_new(&x->x_obj, &x->time);
+  floatinlet_new(&x->x_obj, &x->feedback);
+  floatinlet_new(&x->x_obj, &x->gain);
+
+  x->x_out = outlet_new(&x->x_obj, &s_signal);
+
+  return (void*)x;
+}
+
+static void longdelay_tilde_free(t_longdelay_tilde* x)
+{
+  delete x->delay;
+}
+
+extern "C" void longdelay_tilde_setup(void)
+{
+  longdelay_tilde_class = class_new(gensym("longdelay~"), (t_newmethod)longdelay_tilde_new,
+                                   (t_method)longdelay_tilde_free, sizeof(t_longdelay_tilde),
+                                   CLASS_DEFAULT, A_DEFFLOAT, 0);
+
+  CLASS_MAINSIGNALIN(longdelay_tilde_class, t_longdelay_tilde, x_f);
+
+  class_addmethod(longdelay_tilde_class, (t_method)longdelay_tilde_dsp, gensym("dsp"), A_CANT, 0);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file   moddelay~.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Pd external, modulated feedback delay replacing delay_audio.pd
+ *         (and the modulation from mod_delay.pd) with a single object
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "m_pd.h"
+#include "FeedbackDelay.h"
+
+static t_class* moddelay_tilde_class;
+
+/**
+ * @brief Object struct, inlets match delay_audio.pd
+ *        (signal, clean gain, delay time, feedback, delay gain)
+ * 
+ */
+struct t_moddelay_tilde
+{
+  t_object x_obj;
+  t_float x_f;
+
+  // control inlet values
+  t_float clean, time, feedback, gain;
+
+  // largest delay time (ms), set by creation argument
+  t_float maxMs;
+
+  FeedbackDelay<>* delay;
+
+  t_outlet* x_out;
+};
+
+/**
+ * @brief Perform routine, whole feedback loop in one pass
+ * 
+ */
+static t_int* moddelay_tilde_perform(t_int* w)
+{
+  t_moddelay_tilde* x = (t_moddelay_tilde*)(w[1]);
+  t_sample* in = (t_sample*)(w[2]);
+  t_sample* out = (t_sample*)(w[3]);
+  int n = (int)(w[4]);
+
+  x->delay->setClean(x->clean);
+  x->delay->setTime(x->time);
+  x->delay->setFeedback(x->feedback);
+  x->delay->setGain(x->gain);
+
+  x->delay->process(in, out, n);
+
+  return (w + 5);
+}
+
+/**
+ * @brief Sizes the delay line for the current rate (only place memory is allocated)
+ * 
+ */
+static void moddelay_tilde_dsp(t_moddelay_tilde* x, t_signal** sp)
+{
+  x->delay->prepare(sp[0]->s_sr, x->maxMs);
+
+  dsp_add(moddelay_tilde_perform, 4, x, sp[0]->s_vec, sp[1]->s_vec, (t_int)sp[0]->s_n);
+}
+
+/**
+ * @brief [depth ms( sets random modulation depth
+ * 
+ */
+static void moddelay_tilde_depth(t_moddelay_tilde* x, t_floatarg f)
+{
+  x->delay->setModDepth(f < 0 ? 0 : f);
+}
+
+/**
+ * @brief [rate hz( sets how often a new random offset is picked
+ * 
+ */
+static void moddelay_tilde_rate(t_moddelay_tilde* x, t_floatarg f)
+{
+  x->delay->setModRate(f < 0 ? 0 : f);
+}
+
+/**
+ * @brief [moddelay~ <max ms>], defaults to delay_audio's 2000ms
+ * 
+ */
+static void* moddelay_tilde_new(t_floatarg maxMs)
+{
+  t_moddelay_tilde* x = (t_moddelay_tilde*)pd_new(moddelay_tilde_class);
+
+  x->maxMs = maxMs > 0 ? maxMs : 2000;
+  x->clean = 1;
+  x->time = 0;
+  x->feedback = 0;
+  x->gain = 0;
+
+  x->delay = new FeedbackDelay<>();
+
+  floatinlet_new(&x->x_obj, &x->clean);
+  floatinlet_new(&x->x_obj, &x->time);
+  floatinlet_new(&x->x_obj, &x->feedback);
+  floatinlet_new(&x->x_obj, &x->gain);
+
+  x->x_out = outlet_new(&x->x_obj, &s_signal);
+
+  return (void*)x;
+}
+
+static void moddelay_tilde_free(t_moddelay_tilde* x)
+{
+  delete x->delay;
+}
+
+extern "C" void moddelay_tilde_setup(void)
+{
+  moddelay_tilde_class = class_new(gensym("moddelay~"), (t_newmethod)moddelay_tilde_new,
+                                   (t_method)moddelay_tilde_free, sizeof(t_moddelay_tilde),
+                                   CLASS_DEFAULT, A_DEFFLOAT, 0);
+
+  CLASS_MAINSIGNALIN(moddelay_tilde_class, t_moddelay_tilde, x_f);
+
+  class_addmethod(moddelay_tilde_class, (t_method)moddelay_tilde_dsp, gensym("dsp"), A_CANT, 0);
+  class_addmethod(moddelay_tilde_class, (t_method)moddelay_tilde_depth, gensym("depth"), A_FLOAT, 0);
+  class_addmethod(moddelay_tilde_class, (t_method)moddelay_tilde_rate, gensym("rate"), A_FLOAT, 0);
+}
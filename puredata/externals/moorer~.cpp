@@ -0,0 +1,245 @@
+/**
+ * @file   moorer~.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Pd external, the JUCE plugin's Moorer reverb engine as a single
+ *         object (replaces moorer_reverb.pd's delwrite~/delread~ network)
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "m_pd.h"
+#include "../../juce/MoorerReverb.h"
+
+static t_class* moorer_tilde_class;
+
+/**
+ * @brief Object struct, signal in and the wet/dry mix as a float inlet
+ *
+ */
+struct t_moorer_tilde
+{
+  t_object x_obj;
+  t_float x_f;
+
+  // wet amount (0 - 1), last value handed to the reverb
+  t_float mix, lastMix;
+
+  MoorerReverb* verb;
+
+  t_outlet* x_out;
+};
+
+/**
+ * @brief Perform routine, one block through the block kernel
+ *
+ */
+static t_int* moorer_tilde_perform(t_int* w)
+{
+  t_moorer_tilde* x = (t_moorer_tilde*)(w[1]);
+  t_sample* in = (t_sample*)(w[2]);
+  t_sample* out = (t_sample*)(w[3]);
+  int n = (int)(w[4]);
+
+  if (x->mix != x->lastMix)
+  {
+    x->lastMix = x->mix;
+    x->verb->setMix(x->mix < 0 ? 0 : (x->mix > 1 ? 1 : x->mix));
+  }
+
+  // in and out may be the same buffer, the reverb reads a block before
+  // writing it
+  x->verb->process(in, &out, 1, n);
+
+  return (w + 5);
+}
+
+/**
+ * @brief Brings the reverb up to Pd's rate, the only place delay memory is
+ *        allocated. Parameters (in ms) carry over and tails are kept unless
+ *        the rate actually changed.
+ *
+ */
+static void moorer_tilde_dsp(t_moorer_tilde* x, t_signal** sp)
+{
+  int rate = (int)sp[0]->s_sr;
+
+  if (rate != x->verb->rate)
+  {
+    MoorerParameters p = x->verb->getParameters();
+
+    x->verb->setRate(rate);
+    x->verb->initializeFilters();
+    x->verb->applyParameters(p);
+  }
+
+  dsp_add(moorer_tilde_perform, 4, x, sp[0]->s_vec, sp[1]->s_vec, (t_int)sp[0]->s_n);
+}
+
+/**
+ * @brief [mix value( same as the right inlet
+ *
+ */
+static void moorer_tilde_mix(t_moorer_tilde* x, t_floatarg f)
+{
+  x->mix = f;
+}
+
+/**
+ * @brief Checks a comb index from a message
+ *
+ */
+static bool moorer_tilde_comb(t_moorer_tilde* x, t_floatarg index, const char* name)
+{
+  if (index < 0 || index > 5)
+  {
+    pd_error(x, "moorer~: %s: comb index %g out of range (0 - 5)", name, index);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief [g comb value( sets a comb's lowpass coefficient (R follows, ratio is kept)
+ *
+ */
+static void moorer_tilde_g(t_moorer_tilde* x, t_floatarg index, t_floatarg f)
+{
+  if (!moorer_tilde_comb(x, index, "g"))
+    return;
+
+  LowPassComb& c = x->verb->lp_combs[(int)index];
+  c.g = f;
+  c.R = c.ratio - (c.ratio * c.g);
+}
+
+/**
+ * @brief [R comb value( sets a comb's feedback gain (g follows, ratio is kept)
+ *
+ */
+static void moorer_tilde_R(t_moorer_tilde* x, t_floatarg index, t_floatarg f)
+{
+  if (!moorer_tilde_comb(x, index, "R"))
+    return;
+
+  LowPassComb& c = x->verb->lp_combs[(int)index];
+  c.R = f;
+  c.g = (c.ratio - c.R) / c.ratio;
+}
+
+/**
+ * @brief [ratio comb value( sets a comb's R / (1 - g) ratio
+ *
+ */
+static void moorer_tilde_ratio(t_moorer_tilde* x, t_floatarg index, t_floatarg f)
+{
+  if (!moorer_tilde_comb(x, index, "ratio"))
+    return;
+
+  LowPassComb& c = x->verb->lp_combs[(int)index];
+  c.ratio = f;
+  c.R = c.ratio - (c.ratio * c.g);
+}
+
+/**
+ * @brief [L comb ms( sets a comb's delay (the comb's tail carries on)
+ *
+ */
+static void moorer_tilde_L(t_moorer_tilde* x, t_floatarg index, t_floatarg ms)
+{
+  if (!moorer_tilde_comb(x, index, "L"))
+    return;
+
+  x->verb->lp_combs[(int)index].setDelay((int)std::round(ms * 0.001 * x->verb->rate));
+}
+
+/**
+ * @brief [a value( / [m ms( set the diffuser's coefficient and first stage delay
+ *
+ */
+static void moorer_tilde_a(t_moorer_tilde* x, t_floatarg f)
+{
+  x->verb->diffuser.setCoefficient(f);
+}
+
+static void moorer_tilde_m(t_moorer_tilde* x, t_floatarg ms)
+{
+  x->verb->diffuser.setDelay((int)std::round(ms * 0.001 * x->verb->rate));
+}
+
+/**
+ * @brief [diffusion stages nested( sets the diffuser's stage count (1 is
+ *        Moorer's single allpass) and topology
+ *
+ */
+static void moorer_tilde_diffusion(t_moorer_tilde* x, t_floatarg stages, t_floatarg nested)
+{
+  x->verb->setDiffusion(stages < 1 ? 1 : (int)stages, nested != 0);
+}
+
+/**
+ * @brief [bypass( toggles the reverb / [clear( drops the tail
+ *
+ */
+static void moorer_tilde_bypass(t_moorer_tilde* x)
+{
+  x->verb->setBypass();
+}
+
+static void moorer_tilde_clear(t_moorer_tilde* x)
+{
+  x->verb->reset();
+}
+
+/**
+ * @brief [moorer~ <mix>], Moorer's suggested combs/allpass at Pd's current
+ *        rate, mix defaults to the plugin's 0.2
+ *
+ */
+static void* moorer_tilde_new(t_floatarg mix)
+{
+  t_moorer_tilde* x = (t_moorer_tilde*)pd_new(moorer_tilde_class);
+
+  x->mix = mix > 0 ? mix : 0.2;
+  x->lastMix = x->mix;
+
+  // delay memory is sized for 96khz so common rate changes don't reallocate
+  x->verb = new MoorerReverb();
+  x->verb->setMaxRate(96000);
+  x->verb->setRate((int)sys_getsr());
+  x->verb->initializeFilters();
+  x->verb->setMix(x->mix);
+
+  floatinlet_new(&x->x_obj, &x->mix);
+
+  x->x_out = outlet_new(&x->x_obj, &s_signal);
+
+  return (void*)x;
+}
+
+static void moorer_tilde_free(t_moorer_tilde* x)
+{
+  delete x->verb;
+}
+
+extern "C" void moorer_tilde_setup(void)
+{
+  moorer_tilde_class = class_new(gensym("moorer~"), (t_newmethod)moorer_tilde_new,
+                                 (t_method)moorer_tilde_free, sizeof(t_moorer_tilde),
+                                 CLASS_DEFAULT, A_DEFFLOAT, 0);
+
+  CLASS_MAINSIGNALIN(moorer_tilde_class, t_moorer_tilde, x_f);
+
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_dsp, gensym("dsp"), A_CANT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_mix, gensym("mix"), A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_g, gensym("g"), A_FLOAT, A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_R, gensym("R"), A_FLOAT, A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_ratio, gensym("ratio"), A_FLOAT, A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_L, gensym("L"), A_FLOAT, A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_a, gensym("a"), A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_m, gensym("m"), A_FLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_diffusion, gensym("diffusion"), A_FLOAT, A_DEFFLOAT, 0);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_bypass, gensym("bypass"), A_NULL);
+  class_addmethod(moorer_tilde_class, (t_method)moorer_tilde_clear, gensym("clear"), A_NULL);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file   oscbank~.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Pd external, additive oscillator bank replacing the per peak
+ *         osc~ -> *~ chains in signal_reconstructor.pd
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "m_pd.h"
+#include "OscillatorBank.h"
+
+static t_class* oscbank_tilde_class;
+
+// how long partials take to glide to a new peak (seconds)
+static const double glideSeconds = 0.01;
+
+/**
+ * @brief Object struct, takes sigmund~ peak lists in the left inlet and
+ *        the frequency multiplier (signal_reconstructor's 0-3 slider) in
+ *        the right
+ * 
+ */
+struct t_oscbank_tilde
+{
+  t_object x_obj;
+
+  // frequency multiplier
+  t_float scale;
+
+  OscillatorBank* bank;
+
+  t_outlet* x_out;
+};
+
+/**
+ * @brief Perform routine, renders every partial into the one outlet
+ * 
+ */
+static t_int* oscbank_tilde_perform(t_int* w)
+{
+  t_oscbank_tilde* x = (t_oscbank_tilde*)(w[1]);
+  t_sample* out = (t_sample*)(w[2]);
+  int n = (int)(w[3]);
+
+  x->bank->setScale(x->scale);
+  x->bank->process(out, n);
+
+  return (w + 4);
+}
+
+static void oscbank_tilde_dsp(t_oscbank_tilde* x, t_signal** sp)
+{
+  x->bank->prepare(sp[0]->s_sr, sp[0]->s_n, glideSeconds);
+
+  dsp_add(oscbank_tilde_perform, 3, x, sp[0]->s_vec, (t_int)sp[0]->s_n);
+}
+
+/**
+ * @brief sigmund~ peak list: index, frequency, amplitude (cos/sin parts ignored)
+ * 
+ */
+static void oscbank_tilde_list(t_oscbank_tilde* x, t_symbol*, int argc, t_atom* argv)
+{
+  if (argc < 3)
+    return;
+
+  x->bank->setPartial((int)atom_getfloat(argv), atom_getfloat(argv + 1), atom_getfloat(argv + 2));
+}
+
+/**
+ * @brief [clear( fades every partial out
+ * 
+ */
+static void oscbank_tilde_clear(t_oscbank_tilde* x)
+{
+  x->bank->clear();
+}
+
+/**
+ * @brief [oscbank~ <partials>], defaults to the 10 peaks signal_reconstructor used
+ * 
+ */
+static void* oscbank_tilde_new(t_floatarg partials)
+{
+  t_oscbank_tilde* x = (t_oscbank_tilde*)pd_new(oscbank_tilde_class);
+
+  x->scale = 1;
+
+  x->bank = new OscillatorBank();
+  x->bank->setNumPartials(partials > 0 ? (int)partials : 10);
+
+  floatinlet_new(&x->x_obj, &x->scale);
+
+  x->x_out = outlet_new(&x->x_obj, &s_signal);
+
+  return (void*)x;
+}
+
+static void oscbank_tilde_free(t_oscbank_tilde* x)
+{
+  delete x->bank;
+}
+
+extern "C" void oscbank_tilde_setup(void)
+{
+  oscbank_tilde_class = class_new(gensym("oscbank~"), (t_newmethod)oscbank_tilde_new,
+                                  (t_method)oscbank_tilde_free, sizeof(t_oscbank_tilde),
+                                  CLASS_DEFAULT, A_DEFFLOAT, 0);
+
+  class_addmethod(oscbank_tilde_class, (t_method)oscbank_tilde_dsp, gensym("dsp"), A_CANT, 0);
+  class_addlist(oscbank_tilde_class, (t_method)oscbank_tilde_list);
+  class_addmethod(oscbank_tilde_class, (t_method)oscbank_tilde_clear, gensym("clear"), A_NULL);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file   pitchfollow~.cpp
+ * @author Kailen Swensen (swensenkailen@gmail.com)
+ * @date   2026-10-19
+ * @brief  Pd external, low latency YIN pitch follower replacing the
+ *         sigmund~ pitch -> mtof chain in frequency_follower.pd
+ *
+ * @note   Modified 2026-10-19
+ */
+
+#include "m_pd.h"
+#include "../../juce/Followers.h"
+
+static t_class* pitchfollow_tilde_class;
+
+/**
+ * @brief Object struct, outputs frequency (hz) as a signal, held between
+ *        analyses, and confidence from the right outlet
+ * 
+ */
+struct t_pitchfollow_tilde
+{
+  t_object x_obj;
+  t_float x_f;
+
+  // analysis window/hop (samples)
+  int window, hop;
+
+  PitchTracker* tracker;
+
+  t_outlet* x_out;
+  t_outlet* x_confidence;
+};
+
+static t_int* pitchfollow_tilde_perform(t_int* w)
+{
+  t_pitchfollow_tilde* x = (t_pitchfollow_tilde*)(w[1]);
+  t_sample* in = (t_sample*)(w[2]);
+  t_sample* out = (t_sample*)(w[3]);
+  int n = (int)(w[4]);
+
+  // pd may hand us the same buffer for in and out
+  x->tracker->process(in, n);
+
+  t_sample f = x->tracker->getFrequency();
+  for (int i = 0; i < n; ++i)
+    out[i] = f;
+
+  return (w + 5);
+}
+
+static void pitchfollow_tilde_dsp(t_pitchfollow_tilde* x, t_signal** sp)
+{
+  x->tracker->prepare(sp[0]->s_sr, x->window, x->hop);
+
+  dsp_add(pitchfollow_tilde_perform, 4, x, sp[0]->s_vec, sp[1]->s_vec, (t_int)sp[0]->s_n);
+}
+
+/**
+ * @brief [bang( outputs current confidence
+ * 
+ */
+static void pitchfollow_tilde_bang(t_pitchfollow_tilde* x)
+{
+  outlet_float(x->x_confidence, x->tracker->getConfidence());
+}
+
+/**
+ * @brief [threshold f( sets YIN threshold
+ * 
+ */
+static void pitchfollow_tilde_threshold(t_pitchfollow_tilde* x, t_floatarg f)
+{
+  x->tracker->setThreshold(f);
+}
+
+/**
+ * @brief [pitchfollow~ <window> <hop>], defaults to 1024/128 samples
+ * 
+ */
+static void* pitchfollow_tilde_new(t_floatarg window, t_floatarg hop)
+{
+  t_pitchfollow_tilde* x = (t_pitchfollow_tilde*)pd_new(pitchfollow_tilde_class);
+
+  x->window = window > 0 ? (int)window : 1024;
+  x->hop = hop > 0 ? (int)hop : 128;
+  x->tracker = new PitchTracker();
+
+  x->x_out = outlet_new(&x->x_obj, &s_signal);
+  x->x_confidence = outlet_new(&x->x_obj, &s_float);
+
+  return (void*)x;
+}
+
+static void pitchfollow_tilde_free(t_pitchfollow_tilde* x)
+{
+  delete x->tracker;
+}
+
+extern "C" void pitchfollow_tilde_setup(void)
+{
+  pitchfollow_tilde_class = class_new(gensym("pitchfollow~"), (t_newmethod)pitchfollow_tilde_new,
+                                      (t_method)pitchfollow_tilde_free, sizeof(t_pitchfollow_tilde),
+                                      CLASS_DEFAULT, A_DEFFLOAT, A_DEFFLOAT, 0);
+
+  CLASS_MAINSIGNALIN(pitchfollow_tilde_class, t_pitchfollow_tilde, x_f);
+
+  class_addmethod(pitchfollow_tilde_class, (t_method)pitchfollow_tilde_dsp, gensym("dsp"), A_CANT, 0);
+  class_addbang(pitchfollow_tilde_class, (t_method)pitchfollow_tilde_bang);
+  class_addmethod(pitchfollow_tilde_class, (t_method)pitchfollow_tilde_threshold, gensym("threshold"), A_FLOAT, 0);
+}